@@ -25,6 +25,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <map>
 
 using namespace std;
 using namespace dev;
@@ -170,6 +171,100 @@ inline void hash(
 	memset(a, 0, 200);
 }
 
+/******** Multi-lane Keccak-f[1600] ********/
+
+// Four independent states are permuted at once using 256 bit vectors, one lane per state.
+// The kernel is compiled for AVX2 and only used if the CPU supports it at runtime.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DEV_KECCAK_MULTILANE 1
+
+size_t const c_lanes = 4;
+size_t const c_rate = 200 - (256 / 4);
+
+typedef uint64_t Lanes __attribute__((vector_size(32)));
+
+__attribute__((target("avx2")))
+void keccakfLanes(Lanes* a)
+{
+	Lanes b[5];
+	Lanes d;
+	for (int i = 0; i < 24; i++)
+	{
+		uint8_t x, y;
+		// Theta
+		FOR5(x, 1,
+			b[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20]; )
+		FOR5(x, 1,
+			d = b[(x + 4) % 5] ^ rol(b[(x + 1) % 5], 1);
+			FOR5(y, 5,
+				a[y + x] ^= d; ))
+		// Rho and pi
+		Lanes t = a[1];
+		x = 0;
+		REPEAT24(b[0] = a[pi[x]];
+				a[pi[x]] = rol(t, rho[x]);
+				t = b[0];
+				x++; )
+		// Chi
+		FOR5(y,
+			5,
+			FOR5(x, 1,
+				b[x] = a[y + x];)
+			FOR5(x, 1,
+				a[y + x] = b[x] ^ ((~b[(x + 1) % 5]) & b[(x + 2) % 5]); ))
+		// Iota
+		a[0] ^= RC[i];
+	}
+}
+
+/// Hashes four inputs that need @a _blocks permutations each.
+__attribute__((target("avx2")))
+void hashLanes(bytesConstRef const* _inputs, h256* _outputs, size_t _blocks)
+{
+	Lanes a[25];
+	memset(a, 0, sizeof(a));
+	for (size_t block = 0; block < _blocks; block++)
+	{
+		for (size_t lane = 0; lane < c_lanes; lane++)
+		{
+			bytesConstRef input = _inputs[lane];
+			size_t offset = block * c_rate;
+			uint8_t data[c_rate];
+			if (block + 1 < _blocks)
+				memcpy(data, input.data() + offset, c_rate);
+			else
+			{
+				// Last block: copy the remaining input and apply the padding.
+				size_t remaining = input.size() - offset;
+				memset(data, 0, c_rate);
+				memcpy(data, input.data() + offset, remaining);
+				data[remaining] ^= 0x01;
+				data[c_rate - 1] ^= 0x80;
+			}
+			for (size_t word = 0; word < c_rate / 8; word++)
+			{
+				uint64_t value;
+				memcpy(&value, data + 8 * word, 8);
+				a[word][lane] ^= value;
+			}
+		}
+		keccakfLanes(a);
+	}
+	for (size_t lane = 0; lane < c_lanes; lane++)
+		for (size_t word = 0; word < 4; word++)
+		{
+			uint64_t value = a[word][lane];
+			memcpy(_outputs[lane].data() + 8 * word, &value, 8);
+		}
+}
+
+bool multiLaneAvailable()
+{
+	static bool const available = __builtin_cpu_supports("avx2");
+	return available;
+}
+#endif
+
 }
 
 h256 keccak256(bytesConstRef _input)
@@ -183,4 +278,39 @@ h256 keccak256(bytesConstRef _input)
 	return output;
 }
 
+vector<h256> keccak256Batch(vector<bytesConstRef> const& _inputs)
+{
+	vector<h256> outputs(_inputs.size());
+#ifdef DEV_KECCAK_MULTILANE
+	if (multiLaneAvailable())
+	{
+		// Group the inputs by the number of permutations they need.
+		map<size_t, vector<size_t>> inputsByBlocks;
+		for (size_t i = 0; i < _inputs.size(); i++)
+			inputsByBlocks[_inputs[i].size() / c_rate + 1].push_back(i);
+		for (auto const& group: inputsByBlocks)
+		{
+			vector<size_t> const& indices = group.second;
+			size_t i = 0;
+			for (; i + c_lanes <= indices.size(); i += c_lanes)
+			{
+				bytesConstRef inputs[c_lanes];
+				h256 laneOutputs[c_lanes];
+				for (size_t lane = 0; lane < c_lanes; lane++)
+					inputs[lane] = _inputs[indices[i + lane]];
+				hashLanes(inputs, laneOutputs, group.first);
+				for (size_t lane = 0; lane < c_lanes; lane++)
+					outputs[indices[i + lane]] = laneOutputs[lane];
+			}
+			for (; i < indices.size(); i++)
+				outputs[indices[i]] = keccak256(_inputs[indices[i]]);
+		}
+		return outputs;
+	}
+#endif
+	for (size_t i = 0; i < _inputs.size(); i++)
+		outputs[i] = keccak256(_inputs[i]);
+	return outputs;
+}
+
 }
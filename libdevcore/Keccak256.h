@@ -26,6 +26,7 @@
 #include <libdevcore/FixedHash.h>
 
 #include <string>
+#include <vector>
 
 namespace dev
 {
@@ -42,4 +43,9 @@ inline h256 keccak256(std::string const& _input) { return keccak256(bytesConstRe
 /// Calculate Keccak-256 hash of the given input (presented as a FixedHash), returns a 256-bit hash.
 template<unsigned N> inline h256 keccak256(FixedHash<N> const& _input) { return keccak256(_input.ref()); }
 
+/// Calculate the Keccak-256 hashes of all given inputs, returning them in the same order.
+/// Inputs that need the same number of permutations are hashed in parallel lanes if the CPU
+/// supports it, which is considerably faster than hashing them one by one.
+std::vector<h256> keccak256Batch(std::vector<bytesConstRef> const& _inputs);
+
 }
@@ -25,11 +25,15 @@
 #include <libevmasm/ControlFlowGraph.h>
 #include <libevmasm/PeepholeOptimiser.h>
 #include <libevmasm/JumpdestRemover.h>
+#include <libevmasm/JumpThreader.h>
 #include <libevmasm/BlockDeduplicator.h>
 #include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/GasMeter.h>
 
+#include <atomic>
 #include <fstream>
+#include <future>
+#include <thread>
 #include <json/json.h>
 
 using namespace std;
@@ -454,6 +458,11 @@ map<u256, u256> Assembly::optimiseInternal(
 				}
 				count++;
 			}
+
+			// Shortens jump chains and removes jumps to blocks that are only jumped to once.
+			JumpThreader threader{m_items};
+			if (threader.optimise(_tagsReferencedFromOutside))
+				count++;
 		}
 
 		if (_settings.runCSE)
@@ -517,15 +526,75 @@ map<u256, u256> Assembly::optimiseInternal(
 	return tagReplacements;
 }
 
+size_t Assembly::collectUnassembled(map<Assembly const*, size_t>& _heights) const
+{
+	if (m_assembled)
+		return 0;
+	auto it = _heights.find(this);
+	if (it != _heights.end())
+		return it->second;
+	size_t height = 0;
+	for (auto const& sub: m_subs)
+		height = max(height, sub->collectUnassembled(_heights) + 1);
+	_heights[this] = height;
+	return height;
+}
+
+void Assembly::assembleSubAssemblies() const
+{
+	// Group all sub-assemblies that still have to be assembled by their height in the tree
+	// of sub-assemblies. Assemblies of the same height do not depend on each other and
+	// can be assembled concurrently once all lower levels are done.
+	// Sub-assemblies shared between several parents only appear once.
+	map<Assembly const*, size_t> heights;
+	for (auto const& sub: m_subs)
+		sub->collectUnassembled(heights);
+	vector<vector<Assembly const*>> levels;
+	for (auto const& assemblyAndHeight: heights)
+	{
+		if (levels.size() <= assemblyAndHeight.second)
+			levels.resize(assemblyAndHeight.second + 1);
+		levels[assemblyAndHeight.second].push_back(assemblyAndHeight.first);
+	}
+
+	// The number of threads is bounded by the hardware, each thread takes the next
+	// assembly of the level that is not taken yet.
+	size_t threads = max(1u, thread::hardware_concurrency());
+	for (auto const& level: levels)
+	{
+		atomic<size_t> next{0};
+		auto work = [&]() {
+			for (size_t i = next++; i < level.size(); i = next++)
+				level[i]->assemble();
+		};
+		vector<future<void>> jobs;
+		try
+		{
+			for (size_t i = 1; i < min(threads, level.size()); ++i)
+				jobs.emplace_back(async(launch::async, work));
+		}
+		catch (system_error const&)
+		{
+			// Threads are not available, the remaining assemblies are assembled by this thread.
+		}
+		work();
+		for (auto& job: jobs)
+			job.get();
+	}
+}
+
 LinkerObject const& Assembly::assemble() const
 {
-	if (!m_assembledObject.bytecode.empty())
+	if (m_assembled)
 		return m_assembledObject;
 
+	assembleSubAssemblies();
+
+	vector<LinkerObject const*> subObjects;
 	size_t subTagSize = 1;
 	for (auto const& sub: m_subs)
 	{
-		sub->assemble();
+		subObjects.push_back(&sub->assemble());
 		for (size_t tagPos: sub->m_tagPositionsInBytecode)
 			if (tagPos != size_t(-1) && tagPos > subTagSize)
 				subTagSize = tagPos;
@@ -535,20 +604,27 @@ LinkerObject const& Assembly::assemble() const
 
 	size_t bytesRequiredForCode = bytesRequired(subTagSize);
 	m_tagPositionsInBytecode = vector<size_t>(m_usedTags, -1);
-	map<size_t, pair<size_t, size_t>> tagRef;
-	multimap<h256, unsigned> dataRef;
-	multimap<size_t, size_t> subRef;
+	/// Code locations of pushed tags together with the sub id and the referenced tag.
+	vector<pair<size_t, pair<size_t, size_t>>> tagRef;
+	/// Code locations where the offsets of data items and sub-assemblies are inserted.
+	map<h256, vector<size_t>> dataRef;
+	vector<vector<size_t>> subRef(m_subs.size());
 	vector<unsigned> sizeRef; ///< Pointers to code locations where the size of the program is inserted
 	unsigned bytesPerTag = dev::bytesRequired(bytesRequiredForCode);
 	uint8_t tagPush = (uint8_t)Instruction::PUSH1 - 1 + bytesPerTag;
 
 	unsigned bytesRequiredIncludingData = bytesRequiredForCode + 1 + m_auxiliaryData.size();
-	for (auto const& sub: m_subs)
-		bytesRequiredIncludingData += sub->assemble().bytecode.size();
+	for (LinkerObject const* subObject: subObjects)
+		bytesRequiredIncludingData += subObject->bytecode.size();
 
 	unsigned bytesPerDataRef = dev::bytesRequired(bytesRequiredIncludingData);
 	uint8_t dataRefPush = (uint8_t)Instruction::PUSH1 - 1 + bytesPerDataRef;
-	ret.bytecode.reserve(bytesRequiredIncludingData);
+	// Reserve space for the data as well, so that appending the sub-assemblies and data
+	// does not reallocate.
+	size_t bytesRequiredIncludingAllData = bytesRequiredIncludingData;
+	for (auto const& dataItem: m_data)
+		bytesRequiredIncludingAllData += dataItem.second.size();
+	ret.bytecode.reserve(bytesRequiredIncludingAllData);
 
 	for (AssemblyItem const& i: m_items)
 	{
@@ -586,23 +662,23 @@ LinkerObject const& Assembly::assemble() const
 		case PushTag:
 		{
 			ret.bytecode.push_back(tagPush);
-			tagRef[ret.bytecode.size()] = i.splitForeignPushTag();
+			tagRef.emplace_back(ret.bytecode.size(), i.splitForeignPushTag());
 			ret.bytecode.resize(ret.bytecode.size() + bytesPerTag);
 			break;
 		}
 		case PushData:
 			ret.bytecode.push_back(dataRefPush);
-			dataRef.insert(make_pair((h256)i.data(), ret.bytecode.size()));
+			dataRef[(h256)i.data()].push_back(ret.bytecode.size());
 			ret.bytecode.resize(ret.bytecode.size() + bytesPerDataRef);
 			break;
 		case PushSub:
 			ret.bytecode.push_back(dataRefPush);
-			subRef.insert(make_pair(size_t(i.data()), ret.bytecode.size()));
+			subRef.at(size_t(i.data())).push_back(ret.bytecode.size());
 			ret.bytecode.resize(ret.bytecode.size() + bytesPerDataRef);
 			break;
 		case PushSubSize:
 		{
-			auto s = m_subs.at(size_t(i.data()))->assemble().bytecode.size();
+			auto s = subObjects.at(size_t(i.data()))->bytecode.size();
 			i.setPushedValue(u256(s));
 			uint8_t b = max<unsigned>(1, dev::bytesRequired(s));
 			ret.bytecode.push_back((uint8_t)Instruction::PUSH1 - 1 + b);
@@ -646,15 +722,14 @@ LinkerObject const& Assembly::assemble() const
 
 	for (size_t i = 0; i < m_subs.size(); ++i)
 	{
-		auto references = subRef.equal_range(i);
-		if (references.first == references.second)
+		if (subRef[i].empty())
 			continue;
-		for (auto ref = references.first; ref != references.second; ++ref)
+		for (size_t ref: subRef[i])
 		{
-			bytesRef r(ret.bytecode.data() + ref->second, bytesPerDataRef);
+			bytesRef r(ret.bytecode.data() + ref, bytesPerDataRef);
 			toBigEndian(ret.bytecode.size(), r);
 		}
-		ret.append(m_subs[i]->assemble());
+		ret.append(*subObjects[i]);
 	}
 	for (auto const& i: tagRef)
 	{
@@ -675,12 +750,12 @@ LinkerObject const& Assembly::assemble() const
 	}
 	for (auto const& dataItem: m_data)
 	{
-		auto references = dataRef.equal_range(dataItem.first);
-		if (references.first == references.second)
+		auto references = dataRef.find(dataItem.first);
+		if (references == dataRef.end())
 			continue;
-		for (auto ref = references.first; ref != references.second; ++ref)
+		for (size_t ref: references->second)
 		{
-			bytesRef r(ret.bytecode.data() + ref->second, bytesPerDataRef);
+			bytesRef r(ret.bytecode.data() + ref, bytesPerDataRef);
 			toBigEndian(ret.bytecode.size(), r);
 		}
 		ret.bytecode += dataItem.second;
@@ -693,5 +768,6 @@ LinkerObject const& Assembly::assemble() const
 		bytesRef r(ret.bytecode.data() + pos, bytesPerDataRef);
 		toBigEndian(ret.bytecode.size(), r);
 	}
+	m_assembled = true;
 	return ret;
 }
@@ -163,6 +163,13 @@ private:
 	static Json::Value createJsonValue(std::string _name, int _begin, int _end, std::string _value = std::string(), std::string _jumpType = std::string());
 	static std::string toStringInHex(u256 _value);
 
+	/// Adds this assembly and all its sub-assemblies that are not yet assembled to @a _heights,
+	/// mapping them to their height in the tree of sub-assemblies.
+	/// @returns the height of this assembly.
+	size_t collectUnassembled(std::map<Assembly const*, size_t>& _heights) const;
+	/// Assembles all sub-assemblies (recursively), concurrently where possible.
+	void assembleSubAssemblies() const;
+
 protected:
 	/// 0 is reserved for exception
 	unsigned m_usedTags = 1;
@@ -175,6 +182,7 @@ protected:
 	std::map<h256, std::string> m_strings;
 	std::map<h256, std::string> m_libraries; ///< Identifiers of libraries to be linked.
 
+	mutable bool m_assembled = false;
 	mutable LinkerObject m_assembledObject;
 	mutable std::vector<size_t> m_tagPositionsInBytecode;
 
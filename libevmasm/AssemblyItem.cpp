@@ -21,6 +21,7 @@
 #include <libdevcore/FixedHash.h>
 
 #include <fstream>
+#include <unordered_map>
 
 using namespace std;
 using namespace dev;
@@ -281,3 +282,117 @@ ostream& dev::eth::operator<<(ostream& _out, AssemblyItem const& _item)
 	}
 	return _out;
 }
+
+namespace
+{
+
+/// Appends the decimal representation of @a _value to @a _out without creating
+/// temporary strings.
+void appendNumber(string& _out, int _value)
+{
+	char buffer[12];
+	char* end = buffer + sizeof(buffer);
+	char* begin = end;
+	unsigned absolute = _value < 0 ? unsigned(-(_value + 1)) + 1 : unsigned(_value);
+	do
+	{
+		*--begin = char('0' + absolute % 10);
+		absolute /= 10;
+	}
+	while (absolute > 0);
+	if (_value < 0)
+		*--begin = '-';
+	_out.append(begin, end);
+}
+
+}
+
+string dev::eth::computeSourceMapping(
+	AssemblyItems const& _items,
+	map<string, unsigned> const& _sourceIndicesMap
+)
+{
+	string ret;
+	// Most entries are only the separator or a small number of characters.
+	ret.reserve(_items.size() * 4);
+
+	// Consecutive items almost always share the source, so only look up the name once per source.
+	unordered_map<langutil::CharStream const*, int> sourceIndexCache;
+	auto sourceIndexOf = [&](langutil::SourceLocation const& _location) -> int
+	{
+		if (!_location.source)
+			return -1;
+		auto cached = sourceIndexCache.find(_location.source.get());
+		if (cached != sourceIndexCache.end())
+			return cached->second;
+		auto index = _sourceIndicesMap.find(_location.source->name());
+		int sourceIndex = index != _sourceIndicesMap.end() ? int(index->second) : -1;
+		sourceIndexCache[_location.source.get()] = sourceIndex;
+		return sourceIndex;
+	};
+
+	int prevStart = -1;
+	int prevLength = -1;
+	int prevSourceIndex = -1;
+	char prevJump = 0;
+	for (auto const& item: _items)
+	{
+		if (!ret.empty())
+			ret += ';';
+
+		langutil::SourceLocation const& location = item.location();
+		int length = location.start != -1 && location.end != -1 ? location.end - location.start : -1;
+		int sourceIndex = sourceIndexOf(location);
+		char jump = '-';
+		if (item.getJumpType() == AssemblyItem::JumpType::IntoFunction)
+			jump = 'i';
+		else if (item.getJumpType() == AssemblyItem::JumpType::OutOfFunction)
+			jump = 'o';
+
+		unsigned components = 4;
+		if (jump == prevJump)
+		{
+			components--;
+			if (sourceIndex == prevSourceIndex)
+			{
+				components--;
+				if (length == prevLength)
+				{
+					components--;
+					if (location.start == prevStart)
+						components--;
+				}
+			}
+		}
+
+		if (components-- > 0)
+		{
+			if (location.start != prevStart)
+				appendNumber(ret, location.start);
+			if (components-- > 0)
+			{
+				ret += ':';
+				if (length != prevLength)
+					appendNumber(ret, length);
+				if (components-- > 0)
+				{
+					ret += ':';
+					if (sourceIndex != prevSourceIndex)
+						appendNumber(ret, sourceIndex);
+					if (components-- > 0)
+					{
+						ret += ':';
+						if (jump != prevJump)
+							ret += jump;
+					}
+				}
+			}
+		}
+
+		prevStart = location.start;
+		prevLength = length;
+		prevSourceIndex = sourceIndex;
+		prevJump = jump;
+	}
+	return ret;
+}
@@ -27,7 +27,9 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/Assertions.h>
 #include <iostream>
+#include <map>
 #include <sstream>
+#include <string>
 
 namespace dev
 {
@@ -175,5 +177,12 @@ inline std::ostream& operator<<(std::ostream& _out, AssemblyItems const& _items)
 	return _out;
 }
 
+/// @returns the compressed source mapping ("s:l:f:j;...") of @a _items. Source names are
+/// translated to source indices using @a _sourceIndicesMap.
+std::string computeSourceMapping(
+	AssemblyItems const& _items,
+	std::map<std::string, unsigned> const& _sourceIndicesMap
+);
+
 }
 }
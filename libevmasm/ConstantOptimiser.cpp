@@ -22,10 +22,61 @@
 #include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/Assembly.h>
 #include <libevmasm/GasMeter.h>
+
+#include <mutex>
+#include <tuple>
+
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
+namespace
+{
+
+/// Key of the representation cache: The value and all parameters that influence the search.
+using RepresentationKey = tuple<u256, bool, size_t, size_t, langutil::EVMVersion>;
+
+/// The same constants (masks, selectors, ...) tend to appear in many contracts and
+/// also in the creation and runtime code of the same contract, so the results of
+/// the (expensive) search are shared across all assemblies of the process.
+/// The search is deterministic, so this does not influence the generated code.
+class RepresentationCache
+{
+public:
+	static RepresentationCache& instance()
+	{
+		static RepresentationCache cache;
+		return cache;
+	}
+
+	bool lookup(RepresentationKey const& _key, AssemblyItems& o_routine)
+	{
+		lock_guard<mutex> lock(m_mutex);
+		auto it = m_cache.find(_key);
+		if (it == m_cache.end())
+			return false;
+		o_routine = it->second;
+		return true;
+	}
+
+	void store(RepresentationKey const& _key, AssemblyItems const& _routine)
+	{
+		lock_guard<mutex> lock(m_mutex);
+		// Keep the memory usage of long-running processes bounded.
+		if (m_cache.size() >= c_maxEntries)
+			m_cache.clear();
+		m_cache.emplace(_key, _routine);
+	}
+
+private:
+	static size_t constexpr c_maxEntries = 4096;
+
+	mutex m_mutex;
+	map<RepresentationKey, AssemblyItems> m_cache;
+};
+
+}
+
 unsigned ConstantOptimisationMethod::optimiseConstants(
 	bool _isCreation,
 	size_t _runs,
@@ -185,69 +236,184 @@ AssemblyItems const& CodeCopyMethod::copyRoutine()
 	return copyRoutine;
 }
 
+AssemblyItems ComputeMethod::cachedRepresentation(u256 const& _value)
+{
+	RepresentationKey key{
+		_value,
+		m_params.isCreation,
+		m_params.runs,
+		m_params.multiplicity,
+		m_params.evmVersion
+	};
+	AssemblyItems routine;
+	if (RepresentationCache::instance().lookup(key, routine))
+		return routine;
+	routine = findRepresentation(_value);
+	RepresentationCache::instance().store(key, routine);
+	return routine;
+}
+
 AssemblyItems ComputeMethod::findRepresentation(u256 const& _value)
 {
 	if (_value < 0x10000)
 		// Very small value, not worth computing
 		return AssemblyItems{_value};
-	else if (dev::bytesRequired(~_value) < dev::bytesRequired(_value))
+
+	// Sub-values (especially small multipliers and offsets) are requested repeatedly
+	// while searching, re-use their best representation.
+	auto cached = m_intermediateResults.find(_value);
+	if (cached != m_intermediateResults.end())
+		return cached->second;
+
+	AssemblyItems routine = findDecomposition(_value);
+	bigint bestGas = gasNeeded(routine);
+	auto consider = [&](AssemblyItems _candidate) {
+		bigint candidateGas = gasNeeded(_candidate);
+		if (candidateGas < bestGas)
+		{
+			bestGas = move(candidateGas);
+			routine = move(_candidate);
+		}
+	};
+
+	// The alternatives below only recurse into values that need fewer bytes,
+	// so the search terminates. Its size is bounded by m_maxSteps.
+	if (dev::bytesRequired(~_value) < dev::bytesRequired(_value))
 		// Negated is shorter to represent
-		return findRepresentation(~_value) + AssemblyItems{Instruction::NOT};
-	else
+		consider(findRepresentation(~_value) + AssemblyItems{Instruction::NOT});
+	if (m_maxSteps > 0)
+	{
+		m_maxSteps--;
+		// Difference to the next power of two, which wraps around to zero above 2**255.
+		unsigned bits = boost::multiprecision::msb(_value) + 1;
+		u256 difference = (bits == 256 ? u256(0) : u256(1) << bits) - _value;
+		if (dev::bytesRequired(difference) < dev::bytesRequired(_value))
+			consider(findRepresentation(difference) + powerOfTwo(bits) + AssemblyItems{Instruction::SUB});
+		for (AssemblyItems& candidate: powerRepresentations(_value))
+			consider(move(candidate));
+	}
+	if (m_params.evmVersion.hasBitwiseShifting())
+		for (AssemblyItems& candidate: shiftRepresentations(_value))
+			consider(move(candidate));
+
+	m_intermediateResults[_value] = routine;
+	return routine;
+}
+
+AssemblyItems ComputeMethod::findDecomposition(u256 const& _value)
+{
+	// Decompose value into a * 2**k + b where abs(b) << 2**k
+	// Is not always better, try literal and decomposition method.
+	AssemblyItems routine{u256(_value)};
+	bigint bestGas = gasNeeded(routine);
+	for (unsigned bits = 255; bits > 8 && m_maxSteps > 0; --bits)
 	{
-		// Decompose value into a * 2**k + b where abs(b) << 2**k
-		// Is not always better, try literal and decomposition method.
-		AssemblyItems routine{u256(_value)};
-		bigint bestGas = gasNeeded(routine);
-		for (unsigned bits = 255; bits > 8 && m_maxSteps > 0; --bits)
+		unsigned gapDetector = unsigned((_value >> (bits - 8)) & 0x1ff);
+		if (gapDetector != 0xff && gapDetector != 0x100)
+			continue;
+
+		u256 powerOfTwo = u256(1) << bits;
+		u256 upperPart = _value >> bits;
+		bigint lowerPart = _value & (powerOfTwo - 1);
+		if ((powerOfTwo - lowerPart) < lowerPart)
 		{
-			unsigned gapDetector = unsigned((_value >> (bits - 8)) & 0x1ff);
-			if (gapDetector != 0xff && gapDetector != 0x100)
-				continue;
+			lowerPart = lowerPart - powerOfTwo; // make it negative
+			upperPart++;
+		}
+		if (upperPart == 0)
+			continue;
+		if (abs(lowerPart) >= (powerOfTwo >> 8))
+			continue;
 
-			u256 powerOfTwo = u256(1) << bits;
-			u256 upperPart = _value >> bits;
-			bigint lowerPart = _value & (powerOfTwo - 1);
-			if ((powerOfTwo - lowerPart) < lowerPart)
-			{
-				lowerPart = lowerPart - powerOfTwo; // make it negative
-				upperPart++;
-			}
-			if (upperPart == 0)
-				continue;
-			if (abs(lowerPart) >= (powerOfTwo >> 8))
-				continue;
+		AssemblyItems newRoutine;
+		if (lowerPart != 0)
+			newRoutine += findRepresentation(u256(abs(lowerPart)));
+		if (m_params.evmVersion.hasBitwiseShifting())
+		{
+			newRoutine += findRepresentation(upperPart);
+			newRoutine += AssemblyItems{u256(bits), Instruction::SHL};
+		}
+		else
+		{
+			newRoutine += AssemblyItems{u256(bits), u256(2), Instruction::EXP};
+			if (upperPart != 1)
+				newRoutine += findRepresentation(upperPart) + AssemblyItems{Instruction::MUL};
+		}
+		if (lowerPart > 0)
+			newRoutine += AssemblyItems{Instruction::ADD};
+		else if (lowerPart < 0)
+			newRoutine.push_back(Instruction::SUB);
 
-			AssemblyItems newRoutine;
-			if (lowerPart != 0)
-				newRoutine += findRepresentation(u256(abs(lowerPart)));
-			if (m_params.evmVersion.hasBitwiseShifting())
-			{
-				newRoutine += findRepresentation(upperPart);
-				newRoutine += AssemblyItems{u256(bits), Instruction::SHL};
-			}
-			else
-			{
-				newRoutine += AssemblyItems{u256(bits), u256(2), Instruction::EXP};
-				if (upperPart != 1)
-					newRoutine += findRepresentation(upperPart) + AssemblyItems{Instruction::MUL};
-			}
-			if (lowerPart > 0)
-				newRoutine += AssemblyItems{Instruction::ADD};
-			else if (lowerPart < 0)
-				newRoutine.push_back(Instruction::SUB);
-
-			if (m_maxSteps > 0)
-				m_maxSteps--;
-			bigint newGas = gasNeeded(newRoutine);
-			if (newGas < bestGas)
-			{
-				bestGas = move(newGas);
-				routine = move(newRoutine);
-			}
+		if (m_maxSteps > 0)
+			m_maxSteps--;
+		bigint newGas = gasNeeded(newRoutine);
+		if (newGas < bestGas)
+		{
+			bestGas = move(newGas);
+			routine = move(newRoutine);
 		}
-		return routine;
 	}
+	return routine;
+}
+
+vector<AssemblyItems> ComputeMethod::shiftRepresentations(u256 const& _value)
+{
+	vector<AssemblyItems> representations;
+	unsigned lowestBit = boost::multiprecision::lsb(_value);
+	unsigned highestBit = boost::multiprecision::msb(_value);
+
+	// Masks of the form 0x00..0ff..f, e.g. type(uint160).max
+	if (_value == (~u256(0) >> (255 - highestBit)))
+		representations.push_back(AssemblyItems{
+			u256(0),
+			Instruction::NOT,
+			u256(255 - highestBit),
+			Instruction::SHR
+		});
+	// Masks of the form 0xff..f00..0
+	if (_value == (~u256(0) << lowestBit))
+		representations.push_back(AssemblyItems{
+			u256(0),
+			Instruction::NOT,
+			u256(lowestBit),
+			Instruction::SHL
+		});
+	// Values with at least one trailing zero byte, e.g. left-aligned function selectors
+	if (lowestBit >= 8)
+		representations.push_back(
+			findRepresentation(_value >> lowestBit) +
+			AssemblyItems{u256(lowestBit), Instruction::SHL}
+		);
+	return representations;
+}
+
+vector<AssemblyItems> ComputeMethod::powerRepresentations(u256 const& _value)
+{
+	// Powers of two are already covered by the decomposition.
+	vector<AssemblyItems> representations;
+	for (unsigned base = 3; base <= 0xff; ++base)
+	{
+		u256 remaining = _value;
+		unsigned exponent = 0;
+		while (remaining % base == 0)
+		{
+			remaining /= base;
+			exponent++;
+		}
+		if (remaining == 1)
+			representations.push_back(AssemblyItems{u256(exponent), u256(base), Instruction::EXP});
+	}
+	return representations;
+}
+
+AssemblyItems ComputeMethod::powerOfTwo(unsigned _exponent) const
+{
+	if (_exponent == 256)
+		return AssemblyItems{u256(0)};
+	else if (m_params.evmVersion.hasBitwiseShifting())
+		return AssemblyItems{u256(1), u256(_exponent), Instruction::SHL};
+	else
+		return AssemblyItems{u256(_exponent), u256(2), Instruction::EXP};
 }
 
 bool ComputeMethod::checkRepresentation(u256 const& _value, AssemblyItems const& _routine) const
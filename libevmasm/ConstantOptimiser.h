@@ -29,6 +29,7 @@
 #include <libdevcore/CommonData.h>
 #include <libdevcore/CommonIO.h>
 
+#include <map>
 #include <vector>
 
 namespace dev
@@ -137,7 +138,7 @@ public:
 	explicit ComputeMethod(Params const& _params, u256 const& _value):
 		ConstantOptimisationMethod(_params, _value)
 	{
-		m_routine = findRepresentation(m_value);
+		m_routine = cachedRepresentation(m_value);
 		assertThrow(
 			checkRepresentation(m_value, m_routine),
 			OptimizerException,
@@ -152,14 +153,28 @@ public:
 	}
 
 protected:
+	/// Returns the representation of @a _value from the process-wide cache of results of
+	/// previous searches with the same parameters, running the search on a cache miss.
+	AssemblyItems cachedRepresentation(u256 const& _value);
 	/// Tries to recursively find a way to compute @a _value.
 	AssemblyItems findRepresentation(u256 const& _value);
+	/// Tries to decompose @a _value into a * 2**k + b.
+	AssemblyItems findDecomposition(u256 const& _value);
+	/// @returns representations of @a _value built from shifted constants, requires
+	/// bitwise shifting to be available.
+	std::vector<AssemblyItems> shiftRepresentations(u256 const& _value);
+	/// @returns representations of @a _value as a power of a base other than two, e.g. 10**18.
+	std::vector<AssemblyItems> powerRepresentations(u256 const& _value);
+	/// @returns code that computes 2**@a _exponent modulo 2**256.
+	AssemblyItems powerOfTwo(unsigned _exponent) const;
 	/// Recomputes the value from the calculated representation and checks for correctness.
 	bool checkRepresentation(u256 const& _value, AssemblyItems const& _routine) const;
 	bigint gasNeeded(AssemblyItems const& _routine) const;
 
 	/// Counter for the complexity of optimization, will stop when it reaches zero.
 	size_t m_maxSteps = 10000;
+	/// Best representations of intermediate values found so far during this search.
+	std::map<u256, AssemblyItems> m_intermediateResults;
 	AssemblyItems m_routine;
 };
 
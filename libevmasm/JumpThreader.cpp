@@ -0,0 +1,205 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Jump threading and block layout optimisation.
+ */
+
+#include <libevmasm/JumpThreader.h>
+
+#include <libevmasm/AssemblyItem.h>
+#include <libevmasm/SemanticInformation.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+bool JumpThreader::optimise(set<size_t> const& _tagsReferencedFromOutside)
+{
+	bool changed = threadJumps();
+	// Moving blocks can create new candidates, e.g. by moving a jump out of the block it jumps to.
+	while (moveSingleJumpTargets(_tagsReferencedFromOutside))
+		changed = true;
+	return changed;
+}
+
+bool JumpThreader::threadJumps()
+{
+	map<size_t, size_t> targets = trampolines();
+	if (targets.empty())
+		return false;
+
+	bool changed = false;
+	for (size_t i = 0; i < m_items.size(); ++i)
+		if (isDirectJump(i))
+		{
+			auto target = targets.find(m_items[i].splitForeignPushTag().second);
+			if (target != targets.end())
+			{
+				m_items[i].setPushTagSubIdAndTag(size_t(-1), target->second);
+				changed = true;
+			}
+		}
+	return changed;
+}
+
+bool JumpThreader::moveSingleJumpTargets(set<size_t> const& _tagsReferencedFromOutside)
+{
+	map<size_t, size_t> references;
+	map<size_t, size_t> jumpSites;
+	map<size_t, size_t> tagPositions;
+	for (size_t i = 0; i < m_items.size(); ++i)
+		if (m_items[i].type() == PushTag)
+		{
+			auto subAndTag = m_items[i].splitForeignPushTag();
+			if (subAndTag.first != size_t(-1))
+				continue;
+			references[subAndTag.second]++;
+			if (
+				isDirectJump(i) &&
+				m_items[i + 1] == Instruction::JUMP &&
+				m_items[i + 1].getJumpType() == AssemblyItem::JumpType::Ordinary
+			)
+				jumpSites[subAndTag.second] = i;
+		}
+		else if (m_items[i].type() == Tag)
+			tagPositions[size_t(m_items[i].data())] = i;
+
+	// Blocks to move, indexed by their begin, i.e. the position of their tag, and
+	// the jump sites they are moved to. The blocks do not overlap, since control flow
+	// ends in front of each of them.
+	map<size_t, size_t> blockEnds;
+	map<size_t, size_t> movedBlocks;
+	// @returns the begin of the block to move that contains @a _position, if any.
+	auto containingBlock = [&](size_t _position) -> map<size_t, size_t>::const_iterator {
+		auto block = blockEnds.upper_bound(_position);
+		if (block == blockEnds.begin() || _position >= (--block)->second)
+			return blockEnds.end();
+		return block;
+	};
+	for (auto const& site: jumpSites)
+	{
+		size_t tag = site.first;
+		size_t jump = site.second;
+		if (references[tag] != 1 || _tagsReferencedFromOutside.count(tag) || !tagPositions.count(tag))
+			continue;
+		// The block has to be entered only by the jump, i.e. control flow cannot fall into it.
+		size_t begin = tagPositions[tag];
+		if (begin == 0 || !endsFlow(begin - 1))
+			continue;
+		// Move everything up to the next instruction that does not continue to the next item.
+		// Code that runs until the end of the assembly cannot be moved.
+		size_t end = begin;
+		while (end < m_items.size() && !endsFlow(end))
+			end++;
+		if (end == m_items.size())
+			continue;
+		end++;
+		if (begin <= jump && jump < end)
+			continue;
+		// A block cannot be moved into itself through other moved blocks.
+		bool cycle = false;
+		for (auto container = containingBlock(jump); container != blockEnds.end() && !cycle;)
+		{
+			size_t containerJump = movedBlocks.at(container->first);
+			cycle = begin <= containerJump && containerJump < end;
+			container = containingBlock(containerJump);
+		}
+		if (cycle)
+			continue;
+		blockEnds[begin] = end;
+		movedBlocks[begin] = jump;
+	}
+	if (movedBlocks.empty())
+		return false;
+
+	map<size_t, size_t> blocksAtJumps;
+	for (auto const& block: movedBlocks)
+		blocksAtJumps[block.second] = block.first;
+
+	// Copies the items in one pass, replacing the PushTag and JUMP of every jump site by
+	// its block without its tag. Blocks can contain the jump sites of other blocks, so
+	// the ranges of items that are being copied are kept on a stack.
+	AssemblyItems items;
+	items.reserve(m_items.size());
+	vector<pair<size_t, size_t>> ranges{{0, m_items.size()}};
+	while (!ranges.empty())
+	{
+		size_t i = ranges.back().first;
+		if (i == ranges.back().second)
+		{
+			ranges.pop_back();
+			continue;
+		}
+		ranges.back().first++;
+		if (blockEnds.count(i))
+			ranges.back().first = blockEnds.at(i);
+		else if (blocksAtJumps.count(i))
+		{
+			ranges.back().first++;
+			size_t begin = blocksAtJumps.at(i);
+			ranges.emplace_back(begin + 1, blockEnds.at(begin));
+		}
+		else
+			items.push_back(m_items[i]);
+	}
+	m_items = move(items);
+	return true;
+}
+
+map<size_t, size_t> JumpThreader::trampolines() const
+{
+	map<size_t, size_t> jumps;
+	for (size_t i = 0; i + 2 < m_items.size(); ++i)
+		if (
+			m_items[i].type() == Tag &&
+			isDirectJump(i + 1) &&
+			m_items[i + 2] == Instruction::JUMP &&
+			m_items[i + 2].getJumpType() == AssemblyItem::JumpType::Ordinary
+		)
+			jumps[size_t(m_items[i].data())] = m_items[i + 1].splitForeignPushTag().second;
+
+	// Follow chains of trampolines to their final target, ignoring cycles.
+	map<size_t, size_t> targets;
+	for (auto const& jump: jumps)
+	{
+		set<size_t> visited{jump.first};
+		size_t target = jump.second;
+		while (jumps.count(target) && !visited.count(target))
+		{
+			visited.insert(target);
+			target = jumps.at(target);
+		}
+		if (!visited.count(target))
+			targets[jump.first] = target;
+	}
+	return targets;
+}
+
+bool JumpThreader::isDirectJump(size_t _index) const
+{
+	return
+		_index + 1 < m_items.size() &&
+		m_items[_index].type() == PushTag &&
+		m_items[_index].splitForeignPushTag().first == size_t(-1) &&
+		(m_items[_index + 1] == Instruction::JUMP || m_items[_index + 1] == Instruction::JUMPI);
+}
+
+bool JumpThreader::endsFlow(size_t _index) const
+{
+	AssemblyItem const& item = m_items[_index];
+	return item == Instruction::JUMP || SemanticInformation::terminatesControlFlow(item);
+}
@@ -0,0 +1,75 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Jump threading and block layout optimisation.
+ */
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+class AssemblyItem;
+using AssemblyItems = std::vector<AssemblyItem>;
+
+/**
+ * Optimizer class that
+ *  - retargets direct jumps to blocks that only consist of another unconditional jump
+ *    ("jump threading") and
+ *  - moves blocks that are only reached by a single unconditional jump directly behind
+ *    that jump, so that the jump and the jump destination can be removed.
+ *
+ * Only the tags of direct jumps (i.e. a PushTag immediately followed by JUMP or JUMPI)
+ * are modified, so tags that are stored as values (e.g. internal function pointers) or that
+ * are referenced from outside the assembly keep their meaning.
+ * Modifies the passed vector in place.
+ */
+class JumpThreader
+{
+public:
+	explicit JumpThreader(AssemblyItems& _items): m_items(_items) {}
+
+	/// @returns true if something was changed.
+	bool optimise(std::set<size_t> const& _tagsReferencedFromOutside);
+
+private:
+	/// Retargets jumps to trampoline blocks.
+	/// @returns true if something was changed.
+	bool threadJumps();
+	/// Moves the blocks that are only jumped to from a single place behind those jumps,
+	/// rebuilding the items only once.
+	/// @returns true if something was changed.
+	bool moveSingleJumpTargets(std::set<size_t> const& _tagsReferencedFromOutside);
+
+	/// @returns the blocks that consist only of an unconditional jump to another block
+	/// together with the final target of this jump.
+	std::map<size_t, size_t> trampolines() const;
+	/// @returns true if the item at @a _index is the tag of a direct jump.
+	bool isDirectJump(size_t _index) const;
+	/// @returns true if the control flow cannot continue after the item at @a _index.
+	bool endsFlow(size_t _index) const;
+
+	AssemblyItems& m_items;
+};
+
+}
+}
@@ -183,7 +183,8 @@ vector<pair<FixedHash<4>, FunctionTypePointer>> const& ContractDefinition::inter
 	if (!m_interfaceFunctionList)
 	{
 		set<string> signaturesSeen;
-		m_interfaceFunctionList.reset(new vector<pair<FixedHash<4>, FunctionTypePointer>>());
+		vector<string> signatures;
+		vector<FunctionTypePointer> interfaceFunctions;
 		for (ContractDefinition const* contract: annotation().linearizedBaseContracts)
 		{
 			vector<FunctionTypePointer> functions;
@@ -202,11 +203,15 @@ vector<pair<FixedHash<4>, FunctionTypePointer>> const& ContractDefinition::inter
 				if (signaturesSeen.count(functionSignature) == 0)
 				{
 					signaturesSeen.insert(functionSignature);
-					FixedHash<4> hash(dev::keccak256(functionSignature));
-					m_interfaceFunctionList->emplace_back(hash, fun);
+					signatures.push_back(functionSignature);
+					interfaceFunctions.push_back(fun);
 				}
 			}
 		}
+		vector<h256> hashes = dev::keccak256Batch(vector<bytesConstRef>(signatures.begin(), signatures.end()));
+		m_interfaceFunctionList.reset(new vector<pair<FixedHash<4>, FunctionTypePointer>>());
+		for (size_t i = 0; i < interfaceFunctions.size(); ++i)
+			m_interfaceFunctionList->emplace_back(FixedHash<4>(hashes[i]), interfaceFunctions[i]);
 	}
 	return *m_interfaceFunctionList;
 }
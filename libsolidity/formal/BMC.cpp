@@ -20,18 +20,86 @@
 #include <libsolidity/formal/SMTPortfolio.h>
 #include <libsolidity/formal/SymbolicTypes.h>
 
+#include <libsolidity/ast/ASTVisitor.h>
+
 #include <boost/algorithm/string/replace.hpp>
 
+#include <atomic>
+#include <functional>
+#include <future>
+#include <limits>
+#include <unordered_set>
+
 using namespace std;
 using namespace dev;
 using namespace langutil;
 using namespace dev::solidity;
 
-BMC::BMC(smt::EncodingContext& _context, ErrorReporter& _errorReporter, map<h256, string> const& _smtlib2Responses):
+namespace
+{
+
+shared_ptr<smt::SMTCache> createCache(ModelCheckerSettings const& _settings)
+{
+	if (_settings.cacheDirectory.empty())
+		return nullptr;
+	return make_shared<smt::SMTCache>(_settings.cacheDirectory);
+}
+
+/// @returns the outcome of a verification target with result @a _result for the report.
+string targetResult(smt::CheckResult _result)
+{
+	switch (_result)
+	{
+	case smt::CheckResult::SATISFIABLE:
+		return "violated";
+	case smt::CheckResult::UNSATISFIABLE:
+		return "safe";
+	case smt::CheckResult::UNKNOWN:
+		return "unknown";
+	case smt::CheckResult::CONFLICTING:
+		return "conflicting";
+	case smt::CheckResult::ERROR:
+		return "error";
+	}
+	solAssert(false, "");
+	return "";
+}
+
+/// @returns the variables in @a _expression, indexed by their names.
+map<string, smt::Expression> variables(smt::Expression const& _expression)
+{
+	map<string, smt::Expression> result;
+	unordered_set<smt::Expression, smt::ExpressionHash, smt::ExpressionIdentical> visited;
+	vector<smt::Expression> stack{_expression};
+	while (!stack.empty())
+	{
+		smt::Expression expression = move(stack.back());
+		stack.pop_back();
+		if (!visited.insert(expression).second)
+			continue;
+		if (expression.op() == smt::Operator::Variable)
+			result.emplace(expression.name(), expression);
+		for (auto const& argument: expression.arguments())
+			stack.push_back(argument);
+	}
+	return result;
+}
+
+}
+
+BMC::BMC(
+	smt::EncodingContext& _context,
+	ErrorReporter& _errorReporter,
+	map<h256, string> const& _smtlib2Responses,
+	ModelCheckerSettings _settings
+):
 	SMTEncoder(_context),
 	m_outerErrorReporter(_errorReporter),
-	m_interface(make_shared<smt::SMTPortfolio>(_smtlib2Responses))
+	m_interface(make_shared<smt::SMTPortfolio>(_smtlib2Responses, createCache(_settings), _settings.solverCommand)),
+	m_settings(std::move(_settings)),
+	m_smtlib2Responses(_smtlib2Responses)
 {
+	m_interface->setMemoryLimit(m_settings.memoryLimit);
 #if defined (HAVE_Z3) || defined (HAVE_CVC4)
 	if (!_smtlib2Responses.empty())
 		m_errorReporter.warning(
@@ -49,6 +117,9 @@ void BMC::analyze(SourceUnit const& _source, shared_ptr<Scanner> const& _scanner
 
 	m_scanner = _scanner;
 
+	if (!m_settings.inlineFunctionCalls)
+		summarizeFunctions(_source);
+
 	_source.accept(*this);
 
 	solAssert(m_interface->solvers() > 0, "");
@@ -119,6 +190,15 @@ FunctionDefinition const* BMC::inlinedFunctionCallToDefinition(FunctionCall cons
 
 bool BMC::visit(ContractDefinition const& _contract)
 {
+	m_currentContract = &_contract;
+	m_contractDeadline = m_settings.deadline;
+	if (m_settings.contractTimeout)
+		m_contractDeadline = min(
+			m_contractDeadline,
+			chrono::steady_clock::now() + chrono::milliseconds(m_settings.contractTimeout)
+		);
+	m_skippedTargets = 0;
+
 	SMTEncoder::visit(_contract);
 
 	/// Check targets created by state variable initialization.
@@ -129,6 +209,20 @@ bool BMC::visit(ContractDefinition const& _contract)
 	return true;
 }
 
+void BMC::endVisit(ContractDefinition const& _contract)
+{
+	if (m_skippedTargets > 0)
+		m_errorReporter.warning(
+			_contract.location(),
+			"The time budget of the SMTChecker for this contract was exhausted, " +
+			to_string(m_skippedTargets) +
+			" verification target(s) were not checked."
+		);
+	m_currentContract = nullptr;
+
+	SMTEncoder::endVisit(_contract);
+}
+
 bool BMC::visit(FunctionDefinition const& _function)
 {
 	if (m_callStack.empty())
@@ -142,7 +236,14 @@ bool BMC::visit(FunctionDefinition const& _function)
 
 void BMC::endVisit(FunctionDefinition const& _function)
 {
-	if (isRootFunction())
+	if (isRootFunction() && m_summarizedFunction)
+	{
+		m_summaryConstraints = m_context.assertions();
+		m_summaryReturnValue = boost::none;
+		if (!_function.returnParameters().empty())
+			m_summaryReturnValue = currentValue(*_function.returnParameters().front());
+	}
+	else if (isRootFunction())
 	{
 		smt::Expression constraints = m_context.assertions();
 		checkVerificationTargets(constraints);
@@ -423,6 +524,8 @@ void BMC::inlineFunctionCall(FunctionCall const& _funCall)
 
 		for (auto arg: _funCall.arguments())
 			funArgs.push_back(expr(*arg));
+		if (!m_callStack.empty() && instantiateSummary(_funCall, *funDef, funArgs))
+			return;
 		initializeFunctionCallParameters(*funDef, funArgs);
 
 		// The reason why we need to pushCallStack here instead of visit(FunctionDefinition)
@@ -517,6 +620,175 @@ void BMC::reset()
 	m_loopExecutionHappened = false;
 }
 
+void BMC::summarizeFunctions(SourceUnit const& _source)
+{
+	// The warnings about the summarized functions are reported when they are analyzed on their own.
+	ErrorList errors = m_errorReporter.errors();
+	set<FunctionDefinition const*> visited;
+	function<void(ASTNode const&)> summarizeCalledFunctions = [&](ASTNode const& _node)
+	{
+		SimpleASTVisitor visitor(
+			[&](ASTNode const& _child)
+			{
+				if (auto funCall = dynamic_cast<FunctionCall const*>(&_child))
+					if (auto funDef = inlinedFunctionCallToDefinition(*funCall))
+						if (visited.insert(funDef).second)
+						{
+							// The functions called by the function are summarized first,
+							// so that its summary can use theirs.
+							summarizeCalledFunctions(*funDef);
+							summarizeFunction(*funDef);
+						}
+				return true;
+			},
+			[](ASTNode const&) {}
+		);
+		_node.accept(visitor);
+	};
+	summarizeCalledFunctions(_source);
+	m_errorReporter.clear();
+	m_errorReporter.append(errors);
+}
+
+void BMC::summarizeFunction(FunctionDefinition const& _function)
+{
+	if (
+		m_summaries.count(&_function) ||
+		_function.isConstructor() ||
+		!_function.isImplemented() ||
+		(_function.stateMutability() != StateMutability::Pure && _function.stateMutability() != StateMutability::View) ||
+		_function.returnParameters().size() > 1
+	)
+		return;
+	// The summary only consists of the return value, so changes of arrays and
+	// other reference type arguments would not be visible to the caller.
+	for (auto const& param: _function.parameters())
+		if (dynamic_cast<ReferenceType const*>(param->type()))
+			return;
+
+	size_t errors = m_errorReporter.errors().size();
+	m_summarizedFunction = &_function;
+	reset();
+	m_context.reset();
+	m_context.pushSolver();
+	m_pathConditions.clear();
+	m_uninterpretedTerms.clear();
+	m_arrayAssignmentHappened = false;
+
+	vector<smt::Expression> inputs;
+	vector<VariableDeclaration const*> stateVariables;
+	for (auto const& param: _function.parameters())
+		if (createVariable(*param))
+			inputs.emplace_back(m_context.newValue(*param));
+	if (_function.stateMutability() == StateMutability::View)
+		if (auto contract = dynamic_cast<ContractDefinition const*>(_function.scope()))
+			for (auto base: contract->annotation().linearizedBaseContracts)
+				for (auto var: base->stateVariables())
+					if ((base == contract || var->isVisibleInDerivedContracts()) && createVariable(*var))
+					{
+						inputs.emplace_back(m_context.newValue(*var));
+						stateVariables.emplace_back(var);
+					}
+	for (auto const& variable: _function.localVariables())
+		if (createVariable(*variable))
+			m_context.setZeroValue(*variable);
+	for (auto const& retParam: _function.returnParameters())
+		if (createVariable(*retParam))
+			m_context.setZeroValue(*retParam);
+
+	pushCallStack({&_function, nullptr});
+	_function.accept(*this);
+	m_summarizedFunction = nullptr;
+
+	// Unsupported parts of the function, the environment and external calls
+	// are only encoded correctly when the function is inlined.
+	if (
+		m_errorReporter.errors().size() != errors ||
+		inputs.size() != _function.parameters().size() + stateVariables.size() ||
+		!m_context.globalSymbols().empty() ||
+		m_externalFunctionCallHappened ||
+		m_arrayAssignmentHappened
+	)
+		return;
+	auto constraintVariables = variables(m_summaryConstraints);
+	for (auto const& environment: {m_context.thisAddress(), m_context.balance()})
+		for (auto const& variable: variables(environment))
+			if (constraintVariables.count(variable.first))
+				return;
+
+	FunctionSummary summary{{}, {}, m_summaryReturnValue, boost::none, m_summaryConstraints, {}};
+	for (size_t i = 0; i < inputs.size(); ++i)
+	{
+		bool parameter = i < _function.parameters().size();
+		// Only the state variables that the function reads are inputs.
+		if (parameter || constraintVariables.count(inputs[i].name()))
+		{
+			summary.inputs.emplace_back(inputs[i]);
+			if (!parameter)
+				summary.stateVariables.emplace_back(stateVariables[i - _function.parameters().size()]);
+		}
+		constraintVariables.erase(inputs[i].name());
+	}
+	if (summary.returnValue)
+	{
+		constraintVariables.erase(summary.returnValue->name());
+		vector<smt::SortPointer> domain;
+		for (auto const& input: summary.inputs)
+			if (input.sort()->kind == smt::Kind::Int || input.sort()->kind == smt::Kind::Bool)
+				domain.emplace_back(input.sort());
+		if (!domain.empty() && domain.size() == summary.inputs.size())
+			summary.function = m_context.newVariable(
+				"summary_" + _function.name() + "_" + to_string(_function.id()),
+				make_shared<smt::FunctionSort>(move(domain), summary.returnValue->sort())
+			);
+	}
+	for (auto const& variable: constraintVariables)
+		// Functions are not renamed, since they are the same for all calls.
+		if (variable.second.sort()->kind != smt::Kind::Function)
+			summary.localVariables.emplace_back(variable.second);
+	m_summaries.emplace(&_function, move(summary));
+}
+
+bool BMC::instantiateSummary(
+	FunctionCall const& _funCall,
+	FunctionDefinition const& _function,
+	vector<smt::Expression> const& _arguments
+)
+{
+	auto it = m_summaries.find(&_function);
+	if (it == m_summaries.end())
+		return false;
+	FunctionSummary const& summary = it->second;
+
+	vector<smt::Expression> inputs = _arguments;
+	for (auto var: summary.stateVariables)
+	{
+		if (!m_context.knownVariable(*var))
+			return false;
+		inputs.emplace_back(currentValue(*var));
+	}
+	solAssert(inputs.size() == summary.inputs.size(), "");
+
+	map<string, smt::Expression> substitution;
+	for (size_t i = 0; i < inputs.size(); ++i)
+		substitution.emplace(summary.inputs[i].name(), inputs[i]);
+	string suffix = "_summary_" + to_string(m_summaryInstances++);
+	for (auto const& variable: summary.localVariables)
+		substitution.emplace(variable.name(), m_context.newVariable(variable.name() + suffix, variable.sort()));
+	if (summary.returnValue)
+		substitution.emplace(
+			summary.returnValue->name(),
+			summary.function ?
+				(*summary.function)(inputs) :
+				m_context.newVariable(summary.returnValue->name() + suffix, summary.returnValue->sort())
+		);
+
+	addPathImpliedExpression(summary.constraints.substitute(substitution));
+	if (summary.returnValue)
+		defineExpr(_funCall, summary.returnValue->substitute(substitution));
+	return true;
+}
+
 pair<vector<smt::Expression>, vector<string>> BMC::modelExpressions()
 {
 	vector<smt::Expression> expressionsToEvaluate;
@@ -553,37 +825,42 @@ pair<vector<smt::Expression>, vector<string>> BMC::modelExpressions()
 
 void BMC::checkVerificationTargets(smt::Expression const& _constraints)
 {
-	for (auto& target: m_verificationTargets)
-		checkVerificationTarget(target, _constraints);
+	vector<Query> queries;
+	for (auto const& target: m_verificationTargets)
+		addQueries(target, _constraints, queries);
+	vector<QueryResult> results = checkQueries(queries);
+	for (size_t i = 0; i < queries.size(); ++i)
+		reportQueryResult(queries[i], results[i]);
+	// The conjuncts of the next constraints are mostly different.
+	m_simplifier.clearCache();
+	m_slicer.clearCache();
 }
 
-void BMC::checkVerificationTarget(VerificationTarget& _target, smt::Expression const& _constraints)
+void BMC::addQueries(VerificationTarget const& _target, smt::Expression const& _constraints, vector<Query>& _queries)
 {
 	switch (_target.type)
 	{
-		case VerificationTarget::Type::ConstantCondition:
-			checkConstantCondition(_target);
-			break;
 		case VerificationTarget::Type::Underflow:
-			checkUnderflow(_target, _constraints);
+			_queries.emplace_back(underflowQuery(_target, _constraints));
 			break;
 		case VerificationTarget::Type::Overflow:
-			checkOverflow(_target, _constraints);
+			_queries.emplace_back(overflowQuery(_target, _constraints));
 			break;
 		case VerificationTarget::Type::UnderOverflow:
-			checkUnderflow(_target, _constraints);
-			checkOverflow(_target, _constraints);
+			_queries.emplace_back(underflowQuery(_target, _constraints));
+			_queries.emplace_back(overflowQuery(_target, _constraints));
 			break;
 		case VerificationTarget::Type::DivByZero:
-			checkDivByZero(_target);
+			_queries.emplace_back(divByZeroQuery(_target));
 			break;
 		case VerificationTarget::Type::Balance:
-			checkBalance(_target);
+			_queries.emplace_back(balanceQuery(_target));
 			break;
 		case VerificationTarget::Type::Assert:
-			checkAssert(_target);
+			_queries.emplace_back(assertQuery(_target));
 			break;
 		default:
+			// Constant conditions are checked immediately.
 			solAssert(false, "");
 	}
 }
@@ -599,7 +876,7 @@ void BMC::checkConstantCondition(VerificationTarget& _target)
 	);
 }
 
-void BMC::checkUnderflow(VerificationTarget& _target, smt::Expression const& _constraints)
+BMC::Query BMC::underflowQuery(VerificationTarget const& _target, smt::Expression const& _constraints)
 {
 	solAssert(
 		_target.type == VerificationTarget::Type::Underflow ||
@@ -608,18 +885,19 @@ void BMC::checkUnderflow(VerificationTarget& _target, smt::Expression const& _co
 	);
 	auto intType = dynamic_cast<IntegerType const*>(_target.expression->annotation().type);
 	solAssert(intType, "");
-	checkCondition(
+	return conditionQuery(
 		_target.constraints && _constraints && _target.value < smt::minValue(*intType),
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
+		"underflow",
 		"Underflow (resulting value less than " + formatNumberReadable(intType->minValue()) + ")",
 		"<result>",
 		&_target.value
 	);
 }
 
-void BMC::checkOverflow(VerificationTarget& _target, smt::Expression const& _constraints)
+BMC::Query BMC::overflowQuery(VerificationTarget const& _target, smt::Expression const& _constraints)
 {
 	solAssert(
 		_target.type == VerificationTarget::Type::Overflow ||
@@ -628,52 +906,56 @@ void BMC::checkOverflow(VerificationTarget& _target, smt::Expression const& _con
 	);
 	auto intType = dynamic_cast<IntegerType const*>(_target.expression->annotation().type);
 	solAssert(intType, "");
-	checkCondition(
+	return conditionQuery(
 		_target.constraints && _constraints && _target.value > smt::maxValue(*intType),
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
+		"overflow",
 		"Overflow (resulting value larger than " + formatNumberReadable(intType->maxValue()) + ")",
 		"<result>",
 		&_target.value
 	);
 }
 
-void BMC::checkDivByZero(VerificationTarget& _target)
+BMC::Query BMC::divByZeroQuery(VerificationTarget const& _target)
 {
 	solAssert(_target.type == VerificationTarget::Type::DivByZero, "");
-	checkCondition(
+	return conditionQuery(
 		_target.constraints && (_target.value == 0),
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
+		"division by zero",
 		"Division by zero",
 		"<result>",
 		&_target.value
 	);
 }
 
-void BMC::checkBalance(VerificationTarget& _target)
+BMC::Query BMC::balanceQuery(VerificationTarget const& _target)
 {
 	solAssert(_target.type == VerificationTarget::Type::Balance, "");
-	checkCondition(
+	return conditionQuery(
 		_target.constraints && _target.value,
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
+		"balance",
 		"Insufficient funds",
 		"address(this).balance"
 	);
 }
 
-void BMC::checkAssert(VerificationTarget& _target)
+BMC::Query BMC::assertQuery(VerificationTarget const& _target)
 {
 	solAssert(_target.type == VerificationTarget::Type::Assert, "");
-	checkCondition(
+	return conditionQuery(
 		_target.constraints && !_target.value,
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
+		"assert",
 		"Assertion violation"
 	);
 }
@@ -684,6 +966,10 @@ void BMC::addVerificationTarget(
 	Expression const* _expression
 )
 {
+	// The targets of summarized functions are checked when they are analyzed on their own.
+	if (m_summarizedFunction)
+		return;
+
 	VerificationTarget target{
 		_type,
 		_value,
@@ -693,41 +979,181 @@ void BMC::addVerificationTarget(
 		modelExpressions()
 	};
 	if (_type == VerificationTarget::Type::ConstantCondition)
-		checkVerificationTarget(target);
+		checkConstantCondition(target);
 	else
 		m_verificationTargets.emplace_back(move(target));
 }
 
 /// Solving.
 
-void BMC::checkCondition(
+BMC::Query BMC::conditionQuery(
 	smt::Expression _condition,
-	vector<SMTEncoder::CallStackEntry> const& callStack,
+	vector<SMTEncoder::CallStackEntry> const& _callStack,
 	pair<vector<smt::Expression>, vector<string>> const& _modelExpressions,
 	SourceLocation const& _location,
+	string const& _kind,
 	string const& _description,
 	string const& _additionalValueName,
 	smt::Expression const* _additionalValue
 )
 {
-	m_interface->push();
-	m_interface->addAssertion(_condition);
-
-	vector<smt::Expression> expressionsToEvaluate;
-	vector<string> expressionNames;
-	tie(expressionsToEvaluate, expressionNames) = _modelExpressions;
-	if (callStack.size())
+	Query query{
+		move(_condition),
+		_modelExpressions.first,
+		_modelExpressions.second,
+		_callStack,
+		_location,
+		_kind,
+		_description,
+		smt::Expression(true)
+	};
+	size_t eliminatedNodes = m_simplifier.eliminatedNodes();
+	query.condition = simplify(query.condition);
+	query.eliminatedNodes = m_simplifier.eliminatedNodes() - eliminatedNodes;
+	query.slicedCondition = slice(query.condition);
+	if (_callStack.size())
 	{
 		solAssert(m_scanner, "");
 		if (_additionalValue)
 		{
-			expressionsToEvaluate.emplace_back(*_additionalValue);
-			expressionNames.push_back(_additionalValueName);
+			query.expressionsToEvaluate.emplace_back(*_additionalValue);
+			query.expressionNames.push_back(_additionalValueName);
 		}
 	}
-	smt::CheckResult result;
-	vector<string> values;
-	tie(result, values) = checkSatisfiableAndGenerateModel(expressionsToEvaluate);
+	return query;
+}
+
+vector<BMC::QueryResult> BMC::checkQueries(vector<Query> const& _queries)
+{
+	vector<QueryResult> results(_queries.size());
+	size_t workers = min<size_t>(m_settings.workers, _queries.size());
+	// Without a solver, the queries are collected by the SMT-LIB2 interface
+	// of m_interface, so they have to be sent there.
+	if (workers <= 1 || !m_interface->hasSolver())
+		for (size_t i = 0; i < _queries.size(); ++i)
+			results[i] = checkQuery(*m_interface, _queries[i]);
+	else
+	{
+		while (m_workers.size() < workers)
+			m_workers.emplace_back(createSolver());
+		atomic<size_t> nextQuery{0};
+		vector<future<void>> jobs;
+		for (size_t i = 0; i < workers; ++i)
+		{
+			// Loads the declarations and assertions shared by all queries.
+			m_workers[i]->synchronizeWith(*m_interface);
+			jobs.emplace_back(async(launch::async, [&, solver = m_workers[i].get()]() {
+				for (size_t query = nextQuery++; query < _queries.size(); query = nextQuery++)
+					results[query] = checkQuery(*solver, _queries[query]);
+			}));
+		}
+		for (auto& job: jobs)
+			job.get();
+	}
+
+	if (m_interface->hasSolver())
+		for (size_t i = 0; i < _queries.size(); ++i)
+			checkWithModel(_queries[i], results[i]);
+	return results;
+}
+
+BMC::QueryResult BMC::checkQuery(smt::SMTPortfolio& _solver, Query const& _query) const
+{
+	auto start = chrono::steady_clock::now();
+	QueryResult result;
+	if (!setTimeout(_solver, targetDeadline(start)))
+	{
+		result.result = smt::CheckResult::UNKNOWN;
+		result.skipped = true;
+		return result;
+	}
+
+	// If the condition was sliced, the condition itself is checked afterwards (see checkWithModel).
+	if (_query.slicedCondition.identical(_query.condition))
+		result = checkSatisfiableAndGenerateModel(_solver, _query.condition, _query.expressionsToEvaluate);
+	else
+		result = checkSatisfiableAndGenerateModel(_solver, _query.slicedCondition, {});
+	result.time = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+	return result;
+}
+
+void BMC::checkWithModel(Query const& _query, QueryResult& _result)
+{
+	if (
+		_result.result != smt::CheckResult::SATISFIABLE ||
+		(_query.expressionsToEvaluate.empty() && _query.slicedCondition.identical(_query.condition))
+	)
+		return;
+
+	// The check continues within the time budget of the target.
+	auto start = chrono::steady_clock::now() - _result.time;
+	auto deadline = targetDeadline(start);
+	// The models of a solver depend on the queries it answered before, so a new solver is used,
+	// which makes the models independent of the number of workers and of the order of the queries.
+	auto solver = createSolver();
+	solver->synchronizeWith(*m_interface);
+	if (!setTimeout(*solver, deadline))
+		_result.result = smt::CheckResult::UNKNOWN;
+	else
+		// The models of the sliced condition do not have to satisfy the condition.
+		_result = checkSatisfiableAndGenerateModel(*solver, _query.condition, _query.expressionsToEvaluate);
+	m_modelQueries += solver->unhandledQueries();
+	_result.time = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+}
+
+unique_ptr<smt::SMTPortfolio> BMC::createSolver() const
+{
+	auto solver = make_unique<smt::SMTPortfolio>(
+		m_smtlib2Responses,
+		createCache(m_settings),
+		m_settings.solverCommand
+	);
+	solver->setMemoryLimit(m_settings.memoryLimit);
+	return solver;
+}
+
+chrono::steady_clock::time_point BMC::targetDeadline(chrono::steady_clock::time_point _start) const
+{
+	if (!m_settings.targetTimeout)
+		return m_contractDeadline;
+	return min(m_contractDeadline, _start + chrono::milliseconds(m_settings.targetTimeout));
+}
+
+bool BMC::setTimeout(smt::SolverInterface& _solver, chrono::steady_clock::time_point _deadline)
+{
+	if (_deadline == chrono::steady_clock::time_point::max())
+	{
+		_solver.setTimeout(0);
+		return true;
+	}
+	auto left = _deadline - chrono::steady_clock::now();
+	if (left <= chrono::steady_clock::duration::zero())
+		return false;
+	// Rounds up, since zero means no limit.
+	auto milliseconds = chrono::duration_cast<chrono::milliseconds>(left + chrono::milliseconds(1) - chrono::nanoseconds(1));
+	_solver.setTimeout(unsigned(min<chrono::milliseconds::rep>(milliseconds.count(), numeric_limits<unsigned>::max())));
+	return true;
+}
+
+void BMC::reportQueryResult(Query const& _query, QueryResult const& _result)
+{
+	m_report.push_back({
+		m_currentContract ? m_currentContract->name() : "",
+		_query.location,
+		_query.kind,
+		_result.skipped ? "not checked" : targetResult(_result.result),
+		_result.solver,
+		_result.time,
+		_query.eliminatedNodes
+	});
+	if (_result.skipped)
+	{
+		++m_skippedTargets;
+		return;
+	}
+
+	if (_result.solverError)
+		m_errorReporter.warning(*_result.solverError);
 
 	string extraComment = SMTEncoder::extraComment();
 	if (m_loopExecutionHappened)
@@ -744,53 +1170,51 @@ void BMC::checkCondition(
 	SecondarySourceLocation secondaryLocation{};
 	secondaryLocation.append(extraComment, SourceLocation{});
 
-	switch (result)
+	switch (_result.result)
 	{
 	case smt::CheckResult::SATISFIABLE:
 	{
 		std::ostringstream message;
-		message << _description << " happens here";
-		if (callStack.size())
+		message << _query.description << " happens here";
+		if (_query.callStack.size())
 		{
 			std::ostringstream modelMessage;
 			modelMessage << "  for:\n";
-			solAssert(values.size() == expressionNames.size(), "");
+			solAssert(_result.values.size() == _query.expressionNames.size(), "");
 			map<string, string> sortedModel;
-			for (size_t i = 0; i < values.size(); ++i)
-				if (expressionsToEvaluate.at(i).name != values.at(i))
-					sortedModel[expressionNames.at(i)] = values.at(i);
+			for (size_t i = 0; i < _result.values.size(); ++i)
+				if (_query.expressionsToEvaluate.at(i).name() != _result.values.at(i))
+					sortedModel[_query.expressionNames.at(i)] = _result.values.at(i);
 
 			for (auto const& eval: sortedModel)
 				modelMessage << "  " << eval.first << " = " << eval.second << "\n";
 			m_errorReporter.warning(
-				_location,
+				_query.location,
 				message.str(),
 				SecondarySourceLocation().append(modelMessage.str(), SourceLocation{})
-				.append(SMTEncoder::callStackMessage(callStack))
+				.append(SMTEncoder::callStackMessage(_query.callStack))
 				.append(move(secondaryLocation))
 			);
 		}
 		else
 		{
 			message << ".";
-			m_errorReporter.warning(_location, message.str(), secondaryLocation);
+			m_errorReporter.warning(_query.location, message.str(), secondaryLocation);
 		}
 		break;
 	}
 	case smt::CheckResult::UNSATISFIABLE:
 		break;
 	case smt::CheckResult::UNKNOWN:
-		m_errorReporter.warning(_location, _description + " might happen here.", secondaryLocation);
+		m_errorReporter.warning(_query.location, _query.description + " might happen here.", secondaryLocation);
 		break;
 	case smt::CheckResult::CONFLICTING:
-		m_errorReporter.warning(_location, "At least two SMT solvers provided conflicting answers. Results might not be sound.");
+		m_errorReporter.warning(_query.location, "At least two SMT solvers provided conflicting answers. Results might not be sound.");
 		break;
 	case smt::CheckResult::ERROR:
-		m_errorReporter.warning(_location, "Error trying to invoke SMT solver.");
+		m_errorReporter.warning(_query.location, "Error trying to invoke SMT solver.");
 		break;
 	}
-
-	m_interface->pop();
 }
 
 void BMC::checkBooleanNotConstant(
@@ -805,30 +1229,65 @@ void BMC::checkBooleanNotConstant(
 	if (dynamic_cast<Literal const*>(&_condition))
 		return;
 
-	m_interface->push();
-	m_interface->addAssertion(_constraints && _value);
-	auto positiveResult = checkSatisfiable();
-	m_interface->pop();
+	auto start = chrono::steady_clock::now();
+	auto deadline = targetDeadline(start);
+	VerificationTargetReport report{
+		m_currentContract ? m_currentContract->name() : "",
+		_condition.location(),
+		"constant condition",
+		"not checked",
+		"",
+		{}
+	};
+	ScopeGuard addReport([&]() {
+		report.time = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+		m_report.emplace_back(move(report));
+	});
+	auto check = [&](smt::Expression const& _query) -> boost::optional<QueryResult> {
+		if (!setTimeout(*m_interface, deadline))
+			return boost::none;
+		size_t eliminatedNodes = m_simplifier.eliminatedNodes();
+		smt::Expression query = simplify(_query);
+		report.eliminatedNodes += m_simplifier.eliminatedNodes() - eliminatedNodes;
+		return checkSatisfiable(slice(query));
+	};
 
-	m_interface->push();
-	m_interface->addAssertion(_constraints && !_value);
-	auto negatedResult = checkSatisfiable();
-	m_interface->pop();
+	auto positive = check(_constraints && _value);
+	auto negated = positive ? check(_constraints && !_value) : boost::none;
+	if (!negated)
+	{
+		++m_skippedTargets;
+		return;
+	}
+	auto positiveResult = positive->result;
+	auto negatedResult = negated->result;
+	report.solver = negated->solver.empty() ? positive->solver : negated->solver;
 
 	if (positiveResult == smt::CheckResult::ERROR || negatedResult == smt::CheckResult::ERROR)
+	{
+		report.result = "error";
 		m_errorReporter.warning(_condition.location(), "Error trying to invoke SMT solver.");
+	}
 	else if (positiveResult == smt::CheckResult::CONFLICTING || negatedResult == smt::CheckResult::CONFLICTING)
+	{
+		report.result = "conflicting";
 		m_errorReporter.warning(_condition.location(), "At least two SMT solvers provided conflicting answers. Results might not be sound.");
+	}
 	else if (positiveResult == smt::CheckResult::SATISFIABLE && negatedResult == smt::CheckResult::SATISFIABLE)
 	{
 		// everything fine.
+		report.result = "not constant";
 	}
 	else if (positiveResult == smt::CheckResult::UNKNOWN || negatedResult == smt::CheckResult::UNKNOWN)
 	{
 		// can't do anything.
+		report.result = "unknown";
 	}
 	else if (positiveResult == smt::CheckResult::UNSATISFIABLE && negatedResult == smt::CheckResult::UNSATISFIABLE)
+	{
+		report.result = "unreachable";
 		m_errorReporter.warning(_condition.location(), "Condition unreachable.", SMTEncoder::callStackMessage(_callStack));
+	}
 	else
 	{
 		string value;
@@ -843,6 +1302,7 @@ void BMC::checkBooleanNotConstant(
 			solAssert(negatedResult == smt::CheckResult::SATISFIABLE, "");
 			value = "false";
 		}
+		report.result = "always " + value;
 		m_errorReporter.warning(
 			_condition.location(),
 			boost::algorithm::replace_all_copy(_description, "$VALUE", value),
@@ -851,25 +1311,28 @@ void BMC::checkBooleanNotConstant(
 	}
 }
 
-pair<smt::CheckResult, vector<string>>
-BMC::checkSatisfiableAndGenerateModel(vector<smt::Expression> const& _expressionsToEvaluate)
+BMC::QueryResult BMC::checkSatisfiableAndGenerateModel(
+	smt::SMTPortfolio& _solver,
+	smt::Expression const& _condition,
+	vector<smt::Expression> const& _expressionsToEvaluate
+)
 {
-	smt::CheckResult result;
-	vector<string> values;
+	QueryResult result;
 	try
 	{
-		tie(result, values) = m_interface->check(_expressionsToEvaluate);
+		tie(result.result, result.values) = _solver.checkAssuming({_condition}, _expressionsToEvaluate);
+		result.solver = _solver.answeringSolver();
 	}
 	catch (smt::SolverError const& _e)
 	{
 		string description("Error querying SMT solver");
 		if (_e.comment())
 			description += ": " + *_e.comment();
-		m_errorReporter.warning(description);
-		result = smt::CheckResult::ERROR;
+		result.solverError = description;
+		result.result = smt::CheckResult::ERROR;
 	}
 
-	for (string& value: values)
+	for (string& value: result.values)
 	{
 		try
 		{
@@ -879,11 +1342,33 @@ BMC::checkSatisfiableAndGenerateModel(vector<smt::Expression> const& _expression
 		catch (...) { }
 	}
 
-	return make_pair(result, values);
+	return result;
+}
+
+BMC::QueryResult BMC::checkSatisfiable(smt::Expression const& _condition)
+{
+	QueryResult result = checkSatisfiableAndGenerateModel(*m_interface, _condition, {});
+	if (result.solverError)
+		m_errorReporter.warning(*result.solverError);
+	return result;
 }
 
-smt::CheckResult BMC::checkSatisfiable()
+smt::Expression BMC::slice(smt::Expression const& _formula)
 {
-	return checkSatisfiableAndGenerateModel({}).first;
+	// Without a solver, the queries are answered by the responses given
+	// to the SMT-LIB2 interface, which are keyed by the unsliced queries.
+	if (!m_interface->hasSolver())
+		return _formula;
+
+	auto const& assertions = m_interface->assertions();
+	for (; m_slicerRoots < assertions.size(); ++m_slicerRoots)
+		m_slicer.addRoots(assertions[m_slicerRoots]);
+	return m_slicer.slice(_formula);
 }
 
+smt::Expression BMC::simplify(smt::Expression const& _formula)
+{
+	// Unlike slicing, simplifying does not depend on the available solvers, so that
+	// the queries and the responses given to the SMT-LIB2 interface stay the same.
+	return m_simplifier.simplify(_formula);
+}
@@ -18,7 +18,8 @@
  * Class that implements an SMT-based Bounded Model Checker (BMC).
  * Traverses the AST such that:
  * - Loops are unrolled
- * - Internal function calls are inlined
+ * - Internal function calls are inlined, calls to pure and view functions
+ *   are replaced by instances of summaries of the functions
  * Creates verification targets for:
  * - Underflow/Overflow
  * - Constant conditions
@@ -28,14 +29,23 @@
 #pragma once
 
 
+#include <libsolidity/formal/ConstraintSlicer.h>
 #include <libsolidity/formal/EncodingContext.h>
+#include <libsolidity/formal/ExpressionSimplifier.h>
+#include <libsolidity/formal/ModelCheckerReport.h>
+#include <libsolidity/formal/ModelCheckerSettings.h>
 #include <libsolidity/formal/SMTEncoder.h>
+#include <libsolidity/formal/SMTPortfolio.h>
 #include <libsolidity/formal/SolverInterface.h>
 
 #include <libsolidity/interface/ReadFile.h>
 #include <liblangutil/ErrorReporter.h>
 #include <liblangutil/Scanner.h>
 
+#include <boost/optional.hpp>
+
+#include <chrono>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -53,14 +63,22 @@ namespace solidity
 class BMC: public SMTEncoder
 {
 public:
-	BMC(smt::EncodingContext& _context, langutil::ErrorReporter& _errorReporter, std::map<h256, std::string> const& _smtlib2Responses);
+	BMC(
+		smt::EncodingContext& _context,
+		langutil::ErrorReporter& _errorReporter,
+		std::map<h256, std::string> const& _smtlib2Responses,
+		ModelCheckerSettings _settings = ModelCheckerSettings{}
+	);
 
 	void analyze(SourceUnit const& _sources, std::shared_ptr<langutil::Scanner> const& _scanner);
 
 	/// This is used if the SMT solver is not directly linked into this binary.
 	/// @returns a list of inputs to the SMT solver that were not part of the argument to
 	/// the constructor.
-	std::vector<std::string> unhandledQueries() { return m_interface->unhandledQueries(); }
+	std::vector<std::string> unhandledQueries() { return m_interface->unhandledQueries() + m_modelQueries; }
+
+	/// @returns the verification targets checked so far, in the order they were checked.
+	ModelCheckerReport const& report() const { return m_report; }
 
 	/// @returns the FunctionDefinition of a called function if possible and should inline,
 	/// otherwise nullptr.
@@ -74,6 +92,7 @@ private:
 	/// or checked are visited.
 	//@{
 	bool visit(ContractDefinition const& _node) override;
+	void endVisit(ContractDefinition const& _node) override;
 	bool visit(FunctionDefinition const& _node) override;
 	void endVisit(FunctionDefinition const& _node) override;
 	bool visit(IfStatement const& _node) override;
@@ -108,6 +127,45 @@ private:
 	void resetStorageReferences();
 	void reset();
 
+	/// Function summaries.
+	//@{
+	/// Encoding of an internal pure or view function that is computed once and
+	/// instantiated for every call of the function instead of inlining it.
+	/// The verification targets in the function are only checked when it is analyzed
+	/// on its own, not for every call.
+	struct FunctionSummary
+	{
+		/// Values of the parameters and of the state variables read by the function
+		/// when it is called, which are replaced by their values at the call.
+		std::vector<smt::Expression> inputs;
+		/// State variables whose values are the inputs after the parameters.
+		std::vector<VariableDeclaration const*> stateVariables;
+		/// Value of the return parameter at the end of the function, if there is one.
+		boost::optional<smt::Expression> returnValue;
+		/// Uninterpreted function from the inputs to the return value, so that calls with
+		/// the same inputs are known to have the same result. Only used if all inputs are
+		/// integers or Booleans.
+		boost::optional<smt::Expression> function;
+		/// Constraints of the function in terms of the inputs and the return value.
+		smt::Expression constraints;
+		/// Other variables in the constraints, which are renamed for every call.
+		std::vector<smt::Expression> localVariables;
+	};
+	/// Summarizes the functions called in @a _source and the functions called by them.
+	void summarizeFunctions(SourceUnit const& _source);
+	/// Encodes @a _function with unknown inputs and stores its summary in m_summaries,
+	/// unless the function cannot be summarized or its encoding is not supported.
+	void summarizeFunction(FunctionDefinition const& _function);
+	/// Adds the constraints of the summary of @a _function for @a _funCall with
+	/// the arguments @a _arguments and defines the value of the call.
+	/// @returns false if there is no summary that can be used for the call.
+	bool instantiateSummary(
+		FunctionCall const& _funCall,
+		FunctionDefinition const& _function,
+		std::vector<smt::Expression> const& _arguments
+	);
+	//@}
+
 	std::pair<std::vector<smt::Expression>, std::vector<std::string>> modelExpressions();
 	//@}
 
@@ -123,14 +181,49 @@ private:
 		std::pair<std::vector<smt::Expression>, std::vector<std::string>> modelExpressions;
 	};
 
+	/// Query to the solver that checks whether a verification target can be violated,
+	/// i.e. whether the condition is satisfiable, together with the information
+	/// needed to report the result.
+	struct Query
+	{
+		smt::Expression condition;
+		std::vector<smt::Expression> expressionsToEvaluate;
+		std::vector<std::string> expressionNames;
+		std::vector<CallStackEntry> callStack;
+		langutil::SourceLocation location;
+		/// Kind of the verification target for the report, e.g. "overflow".
+		std::string kind;
+		std::string description;
+		/// Condition that is satisfiable if and only if the condition is, but that may
+		/// be cheaper to check, see ConstraintSlicer.
+		smt::Expression slicedCondition;
+		/// Number of nodes the simplifier removed from the condition.
+		size_t eliminatedNodes = 0;
+	};
+	struct QueryResult
+	{
+		smt::CheckResult result = smt::CheckResult::ERROR;
+		std::vector<std::string> values;
+		/// Description of the error reported by the solver, if any.
+		boost::optional<std::string> solverError;
+		/// Solver that answered, see SMTPortfolio::answeringSolver.
+		std::string solver;
+		std::chrono::milliseconds time{0};
+		/// True if the query was not checked because the time budget of the contract was exhausted.
+		bool skipped = false;
+	};
+
+	/// Checks all verification targets in m_verificationTargets, concurrently if
+	/// more than one worker is configured, and reports the results in their order.
 	void checkVerificationTargets(smt::Expression const& _constraints);
-	void checkVerificationTarget(VerificationTarget& _target, smt::Expression const& _constraints = smt::Expression(true));
+	/// Appends the queries needed to check @a _target to @a _queries.
+	void addQueries(VerificationTarget const& _target, smt::Expression const& _constraints, std::vector<Query>& _queries);
 	void checkConstantCondition(VerificationTarget& _target);
-	void checkUnderflow(VerificationTarget& _target, smt::Expression const& _constraints);
-	void checkOverflow(VerificationTarget& _target, smt::Expression const& _constraints);
-	void checkDivByZero(VerificationTarget& _target);
-	void checkBalance(VerificationTarget& _target);
-	void checkAssert(VerificationTarget& _target);
+	Query underflowQuery(VerificationTarget const& _target, smt::Expression const& _constraints);
+	Query overflowQuery(VerificationTarget const& _target, smt::Expression const& _constraints);
+	Query divByZeroQuery(VerificationTarget const& _target);
+	Query balanceQuery(VerificationTarget const& _target);
+	Query assertQuery(VerificationTarget const& _target);
 	void addVerificationTarget(
 		VerificationTarget::Type _type,
 		smt::Expression const& _value,
@@ -140,16 +233,34 @@ private:
 
 	/// Solver related.
 	//@{
-	/// Check that a condition can be satisfied.
-	void checkCondition(
+	/// @returns the query that checks whether a condition can be satisfied.
+	Query conditionQuery(
 		smt::Expression _condition,
-		std::vector<CallStackEntry> const& callStack,
+		std::vector<CallStackEntry> const& _callStack,
 		std::pair<std::vector<smt::Expression>, std::vector<std::string>> const& _modelExpressions,
 		langutil::SourceLocation const& _location,
+		std::string const& _kind,
 		std::string const& _description,
 		std::string const& _additionalValueName = "",
 		smt::Expression const* _additionalValue = nullptr
 	);
+	/// @returns the results of @a _queries, computed by the workers if there are any.
+	std::vector<QueryResult> checkQueries(std::vector<Query> const& _queries);
+	/// Checks @a _query using @a _solver within the time budgets. Does not report
+	/// anything, so that it can be used from multiple threads with different solvers.
+	/// If a solver is available, only the sliced condition is checked and no model is generated.
+	QueryResult checkQuery(smt::SMTPortfolio& _solver, Query const& _query) const;
+	/// Checks the condition of @a _query with a new solver and generates its model
+	/// if @a _result is satisfiable and the model or the unsliced condition is needed.
+	void checkWithModel(Query const& _query, QueryResult& _result);
+	/// @returns a new solver with the settings of m_interface, but none of its assertions.
+	std::unique_ptr<smt::SMTPortfolio> createSolver() const;
+	/// @returns the time until which a target whose check starts at @a _start may be checked.
+	std::chrono::steady_clock::time_point targetDeadline(std::chrono::steady_clock::time_point _start) const;
+	/// Sets the timeout of @a _solver to the time left until @a _deadline.
+	/// @returns false if there is no time left.
+	static bool setTimeout(smt::SolverInterface& _solver, std::chrono::steady_clock::time_point _deadline);
+	void reportQueryResult(Query const& _query, QueryResult const& _result);
 	/// Checks that a boolean condition is not constant. Do not warn if the expression
 	/// is a literal constant.
 	/// @param _description the warning string, $VALUE will be replaced by the constant value.
@@ -160,10 +271,21 @@ private:
 		std::vector<CallStackEntry> const& _callStack,
 		std::string const& _description
 	);
-	std::pair<smt::CheckResult, std::vector<std::string>>
-	checkSatisfiableAndGenerateModel(std::vector<smt::Expression> const& _expressionsToEvaluate);
+	/// Checks whether the assertions of @a _solver and @a _condition are satisfiable,
+	/// without asserting @a _condition, so that the solver can reuse what it learns
+	/// for the conditions of the next queries.
+	static QueryResult checkSatisfiableAndGenerateModel(
+		smt::SMTPortfolio& _solver,
+		smt::Expression const& _condition,
+		std::vector<smt::Expression> const& _expressionsToEvaluate
+	);
 
-	smt::CheckResult checkSatisfiable();
+	QueryResult checkSatisfiable(smt::Expression const& _condition);
+	/// @returns @a _formula without the constraints that do not influence whether
+	/// it is satisfiable together with the assertions of m_interface.
+	smt::Expression slice(smt::Expression const& _formula);
+	/// @returns a simplified formula that is equivalent to @a _formula, see ExpressionSimplifier.
+	smt::Expression simplify(smt::Expression const& _formula);
 	//@}
 
 	/// Flags used for better warning messages.
@@ -175,7 +297,35 @@ private:
 
 	std::vector<VerificationTarget> m_verificationTargets;
 
-	std::shared_ptr<smt::SolverInterface> m_interface;
+	std::shared_ptr<smt::SMTPortfolio> m_interface;
+
+	ModelCheckerSettings m_settings;
+	std::map<h256, std::string> const& m_smtlib2Responses;
+	/// Solvers of the workers that check verification targets concurrently, created on demand.
+	std::vector<std::unique_ptr<smt::SMTPortfolio>> m_workers;
+	/// Unhandled queries of the solvers created by checkWithModel.
+	std::vector<std::string> m_modelQueries;
+
+	smt::ExpressionSimplifier m_simplifier;
+	smt::ConstraintSlicer m_slicer;
+	/// Number of assertions of m_interface whose variables were added to m_slicer as roots.
+	size_t m_slicerRoots = 0;
+
+	ContractDefinition const* m_currentContract = nullptr;
+	/// Time until which the targets of the current contract may be checked.
+	std::chrono::steady_clock::time_point m_contractDeadline = std::chrono::steady_clock::time_point::max();
+	/// Number of targets of the current contract that were not checked because of its time budget.
+	size_t m_skippedTargets = 0;
+	ModelCheckerReport m_report;
+
+	std::map<FunctionDefinition const*, FunctionSummary> m_summaries;
+	/// Function that is encoded by summarizeFunction, if any.
+	FunctionDefinition const* m_summarizedFunction = nullptr;
+	/// Constraints and return value of m_summarizedFunction at the end of the function.
+	smt::Expression m_summaryConstraints{true};
+	boost::optional<smt::Expression> m_summaryReturnValue;
+	/// Number of instantiated summaries, used to name their variables.
+	size_t m_summaryInstances = 0;
 };
 
 }
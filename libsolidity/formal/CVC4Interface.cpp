@@ -32,20 +32,25 @@ CVC4Interface::CVC4Interface():
 
 void CVC4Interface::reset()
 {
+	m_translatedExpressions.clear();
 	m_variables.clear();
+	m_assumptionLiterals = {{}};
 	m_solver.reset();
 	m_solver.setOption("produce-models", true);
-	m_solver.setTimeLimit(queryTimeout);
+	m_solver.setTimeLimit(m_queryTimeout);
 }
 
 void CVC4Interface::push()
 {
 	m_solver.push();
+	m_assumptionLiterals.emplace_back();
 }
 
 void CVC4Interface::pop()
 {
 	m_solver.pop();
+	solAssert(m_assumptionLiterals.size() > 1, "");
+	m_assumptionLiterals.pop_back();
 }
 
 void CVC4Interface::declareVariable(string const& _name, Sort const& _sort)
@@ -79,12 +84,28 @@ void CVC4Interface::addAssertion(Expression const& _expr)
 }
 
 pair<CheckResult, vector<string>> CVC4Interface::check(vector<Expression> const& _expressionsToEvaluate)
+{
+	return checkAssuming({}, _expressionsToEvaluate);
+}
+
+pair<CheckResult, vector<string>> CVC4Interface::checkAssuming(
+	vector<Expression> const& _assumptions,
+	vector<Expression> const& _expressionsToEvaluate
+)
 {
 	CheckResult result;
 	vector<string> values;
 	try
 	{
-		switch (m_solver.checkSat().isSat())
+		vector<CVC4::Expr> literals;
+		for (Expression const& assumption: _assumptions)
+			literals.emplace_back(assumptionLiteral(assumption));
+		CVC4::Expr assumption;
+		if (literals.size() == 1)
+			assumption = literals.front();
+		else if (literals.size() > 1)
+			assumption = m_context.mkExpr(CVC4::kind::AND, literals);
+		switch (m_solver.checkSat(assumption).isSat())
 		{
 		case CVC4::Result::SAT:
 			result = CheckResult::SATISFIABLE;
@@ -114,25 +135,59 @@ pair<CheckResult, vector<string>> CVC4Interface::check(vector<Expression> const&
 	return make_pair(result, values);
 }
 
+void CVC4Interface::setTimeout(unsigned _milliseconds)
+{
+	SolverInterface::setTimeout(_milliseconds);
+	m_solver.setTimeLimit(_milliseconds);
+}
+
+void CVC4Interface::interrupt()
+{
+	m_solver.interrupt();
+}
+
+string CVC4Interface::identity() const
+{
+	return "cvc4 " + CVC4::Configuration::getVersionString();
+}
+
+CVC4::Expr CVC4Interface::assumptionLiteral(Expression const& _assumption)
+{
+	for (auto const& scope: m_assumptionLiterals)
+	{
+		auto it = scope.find(_assumption);
+		if (it != scope.end())
+			return it->second;
+	}
+	// See Z3Interface::assumptionLiteral.
+	CVC4::Expr literal = m_context.mkVar("assumption", m_context.booleanType());
+	m_solver.assertFormula(m_context.mkExpr(CVC4::kind::IMPLIES, literal, toCVC4Expr(_assumption)));
+	m_assumptionLiterals.back().emplace(_assumption, literal);
+	return literal;
+}
+
 CVC4::Expr CVC4Interface::toCVC4Expr(Expression const& _expr)
 {
-	// Variable
-	if (_expr.arguments.empty() && m_variables.count(_expr.name))
-		return m_variables.at(_expr.name);
+	auto it = m_translatedExpressions.find(_expr);
+	if (it != m_translatedExpressions.end())
+		return it->second;
+	CVC4::Expr result = translate(_expr);
+	m_translatedExpressions.emplace(_expr, result);
+	return result;
+}
 
+CVC4::Expr CVC4Interface::translate(Expression const& _expr)
+{
 	vector<CVC4::Expr> arguments;
-	for (auto const& arg: _expr.arguments)
+	for (auto const& arg: _expr.arguments())
 		arguments.push_back(toCVC4Expr(arg));
 
 	try
 	{
-		string const& n = _expr.name;
-		// Function application
-		if (!arguments.empty() && m_variables.count(_expr.name))
-			return m_context.mkExpr(CVC4::kind::APPLY_UF, m_variables.at(n), arguments);
-		// Literal
-		else if (arguments.empty())
+		string const& n = _expr.name();
+		switch (_expr.op())
 		{
+		case Operator::Literal:
 			if (n == "true")
 				return m_context.mkConst(true);
 			else if (n == "false")
@@ -150,43 +205,56 @@ CVC4::Expr CVC4Interface::toCVC4Expr(Expression const& _expr)
 				{
 					solAssert(false, _e.what());
 				}
+		case Operator::Variable:
+			solAssert(m_variables.count(n), "Undeclared variable " + n);
+			return m_variables.at(n);
+		case Operator::Application:
+			solAssert(m_variables.count(n), "Undeclared function " + n);
+			return m_context.mkExpr(CVC4::kind::APPLY_UF, m_variables.at(n), arguments);
+		default:
+			break;
 		}
 
 		solAssert(_expr.hasCorrectArity(), "");
-		if (n == "ite")
+		switch (_expr.op())
+		{
+		case Operator::Ite:
 			return arguments[0].iteExpr(arguments[1], arguments[2]);
-		else if (n == "not")
+		case Operator::Not:
 			return arguments[0].notExpr();
-		else if (n == "and")
+		case Operator::And:
 			return arguments[0].andExpr(arguments[1]);
-		else if (n == "or")
+		case Operator::Or:
 			return arguments[0].orExpr(arguments[1]);
-		else if (n == "implies")
+		case Operator::Implies:
 			return m_context.mkExpr(CVC4::kind::IMPLIES, arguments[0], arguments[1]);
-		else if (n == "=")
+		case Operator::Equal:
 			return m_context.mkExpr(CVC4::kind::EQUAL, arguments[0], arguments[1]);
-		else if (n == "<")
+		case Operator::Less:
 			return m_context.mkExpr(CVC4::kind::LT, arguments[0], arguments[1]);
-		else if (n == "<=")
+		case Operator::LessOrEqual:
 			return m_context.mkExpr(CVC4::kind::LEQ, arguments[0], arguments[1]);
-		else if (n == ">")
+		case Operator::Greater:
 			return m_context.mkExpr(CVC4::kind::GT, arguments[0], arguments[1]);
-		else if (n == ">=")
+		case Operator::GreaterOrEqual:
 			return m_context.mkExpr(CVC4::kind::GEQ, arguments[0], arguments[1]);
-		else if (n == "+")
+		case Operator::Add:
 			return m_context.mkExpr(CVC4::kind::PLUS, arguments[0], arguments[1]);
-		else if (n == "-")
+		case Operator::Sub:
 			return m_context.mkExpr(CVC4::kind::MINUS, arguments[0], arguments[1]);
-		else if (n == "*")
+		case Operator::Mul:
 			return m_context.mkExpr(CVC4::kind::MULT, arguments[0], arguments[1]);
-		else if (n == "/")
+		case Operator::Div:
 			return m_context.mkExpr(CVC4::kind::INTS_DIVISION_TOTAL, arguments[0], arguments[1]);
-		else if (n == "mod")
+		case Operator::Mod:
 			return m_context.mkExpr(CVC4::kind::INTS_MODULUS, arguments[0], arguments[1]);
-		else if (n == "select")
+		case Operator::Select:
 			return m_context.mkExpr(CVC4::kind::SELECT, arguments[0], arguments[1]);
-		else if (n == "store")
+		case Operator::Store:
 			return m_context.mkExpr(CVC4::kind::STORE, arguments[0], arguments[1], arguments[2]);
+		default:
+			break;
+		}
 
 		solAssert(false, "");
 	}
@@ -54,15 +54,32 @@ public:
 
 	void addAssertion(Expression const& _expr) override;
 	std::pair<CheckResult, std::vector<std::string>> check(std::vector<Expression> const& _expressionsToEvaluate) override;
+	std::pair<CheckResult, std::vector<std::string>> checkAssuming(
+		std::vector<Expression> const& _assumptions,
+		std::vector<Expression> const& _expressionsToEvaluate
+	) override;
+	void interrupt() override;
+
+	std::string identity() const override;
+
+	void setTimeout(unsigned _milliseconds) override;
 
 private:
+	/// @returns the translation of @a _expr, which is only computed once per expression.
 	CVC4::Expr toCVC4Expr(Expression const& _expr);
+	CVC4::Expr translate(Expression const& _expr);
 	CVC4::Type cvc4Sort(smt::Sort const& _sort);
 	std::vector<CVC4::Type> cvc4Sort(std::vector<smt::SortPointer> const& _sorts);
+	/// @returns a fresh Boolean variable that implies @a _assumption in the current scope,
+	/// which is only created once per assumption and scope.
+	CVC4::Expr assumptionLiteral(Expression const& _assumption);
 
 	CVC4::ExprManager m_context;
 	CVC4::SmtEngine m_solver;
 	std::map<std::string, CVC4::Expr> m_variables;
+	ExpressionMap<CVC4::Expr> m_translatedExpressions;
+	/// Literals of the assumptions per scope opened by push, the first element is the outermost scope.
+	std::vector<ExpressionMap<CVC4::Expr>> m_assumptionLiterals{{}};
 };
 
 }
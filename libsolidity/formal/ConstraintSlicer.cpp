@@ -0,0 +1,184 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/formal/ConstraintSlicer.h>
+
+#include <libdevcore/CommonData.h>
+
+#include <boost/optional.hpp>
+
+#include <functional>
+#include <map>
+#include <unordered_set>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity::smt;
+
+namespace
+{
+
+using ExpressionSet = unordered_set<Expression, ExpressionHash, ExpressionIdentical>;
+
+/// @returns the conjuncts of @a _formula without duplicates, in the order of occurrence.
+vector<Expression> conjuncts(Expression const& _formula)
+{
+	vector<Expression> result;
+	ExpressionSet visited;
+	// The conjunctions are deeply nested, so an explicit stack is used.
+	vector<Expression> stack{_formula};
+	while (!stack.empty())
+	{
+		Expression expression = move(stack.back());
+		stack.pop_back();
+		if (!visited.insert(expression).second)
+			continue;
+		if (expression.op() == Operator::And)
+		{
+			stack.emplace_back(expression.arguments()[1]);
+			stack.emplace_back(expression.arguments()[0]);
+		}
+		else if (!(expression.op() == Operator::Literal && expression.name() == "true"))
+			result.emplace_back(move(expression));
+	}
+	return result;
+}
+
+bool isVariable(Expression const& _expression)
+{
+	return _expression.op() == Operator::Variable && _expression.sort()->kind != Kind::Function;
+}
+
+}
+
+void ConstraintSlicer::addRoots(Expression const& _assertion)
+{
+	collectVariables(_assertion, m_roots);
+}
+
+Expression ConstraintSlicer::slice(Expression const& _formula)
+{
+	vector<Expression> parts = conjuncts(_formula);
+
+	map<string, size_t> definitions;
+	vector<bool> kept(parts.size(), false);
+	vector<string> pending(m_roots.begin(), m_roots.end());
+	for (size_t i = 0; i < parts.size(); ++i)
+	{
+		string defined = definedVariable(parts[i]);
+		if (!defined.empty() && !definitions.count(defined))
+			definitions[defined] = i;
+		else
+		{
+			kept[i] = true;
+			pending += variables(parts[i]);
+		}
+	}
+
+	set<string> reached;
+	while (!pending.empty())
+	{
+		string variable = move(pending.back());
+		pending.pop_back();
+		if (!reached.insert(variable).second || !definitions.count(variable))
+			continue;
+		size_t definition = definitions.at(variable);
+		kept[definition] = true;
+		pending += variables(parts[definition]);
+	}
+
+	// Checks that the removed definitions do not depend on each other cyclically.
+	map<string, int> state;
+	function<bool(string const&)> cyclic = [&](string const& _variable)
+	{
+		if (reached.count(_variable) || !definitions.count(_variable))
+			return false;
+		int& variableState = state[_variable];
+		if (variableState == 2)
+			return false;
+		if (variableState == 1)
+			return true;
+		variableState = 1;
+		for (string const& used: variables(parts[definitions.at(_variable)]))
+			if (used != _variable && cyclic(used))
+				return true;
+		state[_variable] = 2;
+		return false;
+	};
+	bool removedAny = false;
+	for (auto const& definition: definitions)
+		if (!kept[definition.second])
+		{
+			removedAny = true;
+			if (cyclic(definition.first))
+				return _formula;
+		}
+	if (!removedAny)
+		return _formula;
+
+	boost::optional<Expression> result;
+	for (size_t i = 0; i < parts.size(); ++i)
+		if (kept[i])
+			result = result ? *result && parts[i] : parts[i];
+	return result ? *result : Expression(true);
+}
+
+vector<string> const& ConstraintSlicer::variables(Expression const& _conjunct)
+{
+	auto it = m_variables.find(_conjunct);
+	if (it == m_variables.end())
+	{
+		set<string> variables;
+		collectVariables(_conjunct, variables);
+		it = m_variables.emplace(_conjunct, vector<string>(variables.begin(), variables.end())).first;
+	}
+	return it->second;
+}
+
+void ConstraintSlicer::collectVariables(Expression const& _expression, set<string>& _variables)
+{
+	ExpressionSet visited;
+	vector<Expression> stack{_expression};
+	while (!stack.empty())
+	{
+		Expression expression = move(stack.back());
+		stack.pop_back();
+		if (!visited.insert(expression).second)
+			continue;
+		if (isVariable(expression))
+			_variables.insert(expression.name());
+		for (auto const& argument: expression.arguments())
+			stack.emplace_back(argument);
+	}
+}
+
+string ConstraintSlicer::definedVariable(Expression const& _conjunct)
+{
+	if (_conjunct.op() != Operator::Equal)
+		return {};
+	for (size_t side = 0; side < 2; ++side)
+	{
+		Expression const& variable = _conjunct.arguments()[side];
+		if (!isVariable(variable))
+			continue;
+		set<string> used;
+		collectVariables(_conjunct.arguments()[1 - side], used);
+		if (!used.count(variable.name()))
+			return variable.name();
+	}
+	return {};
+}
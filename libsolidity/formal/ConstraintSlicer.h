@@ -0,0 +1,79 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Cone-of-influence reduction of SMT formulas.
+ */
+
+#pragma once
+
+#include <libsolidity/formal/SolverInterface.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+namespace smt
+{
+
+/**
+ * Removes the conjuncts of a formula that cannot influence whether it is satisfiable.
+ *
+ * The formula is split into its conjuncts. A conjunct of the form `v = e`, where v
+ * is a variable that does not occur in e, is the definition of v, unless v already
+ * has a definition. The other conjuncts are kept, together with the definitions of the
+ * variables they use, transitively. The remaining definitions can be removed, because
+ * the values of their variables can always be chosen such that they hold.
+ * This requires that the removed definitions do not depend on each other cyclically,
+ * which is always the case for the SSA variables of the encoding; if they do,
+ * the formula is not changed.
+ *
+ * The sliced formula is satisfiable if and only if the original one is, but its
+ * models do not necessarily satisfy the original formula.
+ *
+ * Variables that are constrained by the assertions of the solver have to be added
+ * as roots, so that their definitions are kept.
+ */
+class ConstraintSlicer
+{
+public:
+	/// Keeps the definitions of all variables used in @a _assertion.
+	void addRoots(Expression const& _assertion);
+
+	Expression slice(Expression const& _formula);
+
+	/// Clears the cached variables of conjuncts.
+	void clearCache() { m_variables.clear(); }
+
+private:
+	/// @returns the variables used in @a _expression (without functions), cached
+	/// for conjuncts.
+	std::vector<std::string> const& variables(Expression const& _conjunct);
+	static void collectVariables(Expression const& _expression, std::set<std::string>& _variables);
+	/// @returns the variable @a _conjunct defines or an empty string if it is not a definition.
+	static std::string definedVariable(Expression const& _conjunct);
+
+	std::set<std::string> m_roots;
+	ExpressionMap<std::vector<std::string>> m_variables;
+};
+
+}
+}
+}
@@ -0,0 +1,263 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/formal/ExpressionSimplifier.h>
+
+#include <boost/optional.hpp>
+
+#include <unordered_set>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity::smt;
+
+namespace
+{
+
+using ExpressionSet = unordered_set<Expression, ExpressionHash, ExpressionIdentical>;
+
+/// @returns the conjuncts of the conjunction @a _conjunction without duplicates,
+/// in the order of occurrence, and the number of distinct conjunctions it consists of.
+pair<vector<Expression>, size_t> conjuncts(Expression const& _conjunction)
+{
+	vector<Expression> result;
+	size_t conjunctions = 0;
+	ExpressionSet visited;
+	// The conjunctions are deeply nested, so an explicit stack is used.
+	vector<Expression> stack{_conjunction};
+	while (!stack.empty())
+	{
+		Expression expression = move(stack.back());
+		stack.pop_back();
+		if (!visited.insert(expression).second)
+			continue;
+		if (expression.op() == Operator::And)
+		{
+			conjunctions++;
+			stack.emplace_back(expression.arguments()[1]);
+			stack.emplace_back(expression.arguments()[0]);
+		}
+		else
+			result.emplace_back(move(expression));
+	}
+	return {move(result), conjunctions};
+}
+
+bool isBoolLiteral(Expression const& _expression, bool _value)
+{
+	return _expression.op() == Operator::Literal && _expression.name() == (_value ? "true" : "false");
+}
+
+boost::optional<bigint> intLiteral(Expression const& _expression)
+{
+	if (_expression.op() != Operator::Literal || _expression.sort()->kind != Kind::Int)
+		return boost::none;
+	return bigint(_expression.name());
+}
+
+}
+
+Expression ExpressionSimplifier::simplify(Expression const& _formula)
+{
+	// Post-order traversal with an explicit stack, since the formulas are deeply nested.
+	// The second component is true if the arguments were already pushed.
+	vector<pair<Expression, bool>> stack{{_formula, false}};
+	while (!stack.empty())
+	{
+		Expression expression = stack.back().first;
+		if (m_simplified.count(expression))
+		{
+			stack.pop_back();
+			continue;
+		}
+		if (!stack.back().second)
+		{
+			stack.back().second = true;
+			// Conjunctions are simplified as a whole, so only their conjuncts are visited.
+			vector<Expression> arguments =
+				expression.op() == Operator::And ?
+				conjuncts(expression).first :
+				expression.arguments();
+			for (auto& argument: arguments)
+				if (!m_simplified.count(argument))
+					stack.emplace_back(move(argument), false);
+			continue;
+		}
+		stack.pop_back();
+
+		if (expression.op() == Operator::And)
+			m_simplified.emplace(expression, simplifyConjunction(expression));
+		else
+		{
+			vector<Expression> arguments;
+			for (auto const& argument: expression.arguments())
+				arguments.emplace_back(m_simplified.at(argument));
+			m_simplified.emplace(expression, simplifyNode(expression, move(arguments)));
+		}
+	}
+	return m_simplified.at(_formula);
+}
+
+Expression ExpressionSimplifier::simplifyNode(Expression const& _expression, vector<Expression> _arguments)
+{
+	boost::optional<Expression> result;
+	auto const& a = _arguments.size() > 0 ? _arguments[0] : _expression;
+	auto const& b = _arguments.size() > 1 ? _arguments[1] : _expression;
+	auto aValue = intLiteral(a);
+	auto bValue = intLiteral(b);
+	bool literals = aValue && bValue;
+	switch (_expression.op())
+	{
+	case Operator::Not:
+		if (isBoolLiteral(a, true) || isBoolLiteral(a, false))
+			result = Expression(isBoolLiteral(a, false));
+		else if (a.op() == Operator::Not)
+			result = a.arguments()[0];
+		break;
+	case Operator::Or:
+		if (isBoolLiteral(a, true) || isBoolLiteral(b, true))
+			result = Expression(true);
+		else if (isBoolLiteral(a, false) || a.identical(b))
+			result = b;
+		else if (isBoolLiteral(b, false))
+			result = a;
+		break;
+	case Operator::Implies:
+		if (isBoolLiteral(a, false) || isBoolLiteral(b, true) || a.identical(b))
+			result = Expression(true);
+		else if (isBoolLiteral(a, true))
+			result = b;
+		else if (isBoolLiteral(b, false))
+			result = !a;
+		break;
+	case Operator::Ite:
+	{
+		auto const& falseValue = _arguments[2];
+		if (isBoolLiteral(a, true) || b.identical(falseValue))
+			result = b;
+		else if (isBoolLiteral(a, false))
+			result = falseValue;
+		else if (isBoolLiteral(b, true) && isBoolLiteral(falseValue, false))
+			result = a;
+		else if (isBoolLiteral(b, false) && isBoolLiteral(falseValue, true))
+			result = !a;
+		break;
+	}
+	case Operator::Equal:
+		if (a.identical(b))
+			result = Expression(true);
+		else if (literals)
+			result = Expression(*aValue == *bValue);
+		else if (a.op() == Operator::Literal && b.op() == Operator::Literal && a.sort()->kind == Kind::Bool)
+			// Different boolean literals.
+			result = Expression(false);
+		break;
+	case Operator::Less:
+	case Operator::Greater:
+		if (a.identical(b))
+			result = Expression(false);
+		else if (literals)
+			result = Expression(_expression.op() == Operator::Less ? *aValue < *bValue : *aValue > *bValue);
+		break;
+	case Operator::LessOrEqual:
+	case Operator::GreaterOrEqual:
+		if (a.identical(b))
+			result = Expression(true);
+		else if (literals)
+			result = Expression(_expression.op() == Operator::LessOrEqual ? *aValue <= *bValue : *aValue >= *bValue);
+		break;
+	case Operator::Add:
+		if (literals)
+			result = Expression(bigint(*aValue + *bValue));
+		else if (aValue && *aValue == 0)
+			result = b;
+		else if (bValue && *bValue == 0)
+			result = a;
+		break;
+	case Operator::Sub:
+		if (literals)
+			result = Expression(bigint(*aValue - *bValue));
+		else if (bValue && *bValue == 0)
+			result = a;
+		else if (a.identical(b))
+			result = Expression(bigint(0));
+		break;
+	case Operator::Mul:
+		if (literals)
+			result = Expression(bigint(*aValue * *bValue));
+		else if ((aValue && *aValue == 0) || (bValue && *bValue == 1))
+			result = a;
+		else if ((bValue && *bValue == 0) || (aValue && *aValue == 1))
+			result = b;
+		break;
+	case Operator::Div:
+	case Operator::Mod:
+		// Integer division of SMT-LIB rounds towards negative infinity for positive
+		// divisors, which only agrees with C++ for non-negative dividends.
+		// Division by zero is unspecified, so it is never folded.
+		if (literals && *aValue >= 0 && *bValue > 0)
+			result = Expression(_expression.op() == Operator::Div ? bigint(*aValue / *bValue) : bigint(*aValue % *bValue));
+		else if (bValue && *bValue == 1)
+			result = _expression.op() == Operator::Div ? a : Expression(bigint(0));
+		break;
+	default:
+		break;
+	}
+
+	if (result)
+	{
+		m_eliminatedNodes++;
+		return *result;
+	}
+	for (size_t i = 0; i < _arguments.size(); ++i)
+		if (!_arguments[i].identical(_expression.arguments()[i]))
+			return Expression(_expression.op(), _expression.name(), move(_arguments), _expression.sort());
+	return _expression;
+}
+
+Expression ExpressionSimplifier::simplifyConjunction(Expression const& _conjunction)
+{
+	auto parts = conjuncts(_conjunction);
+	vector<Expression> kept;
+	ExpressionSet keptSet;
+	bool changed = false;
+	for (auto const& conjunct: parts.first)
+	{
+		Expression const& simplified = m_simplified.at(conjunct);
+		if (isBoolLiteral(simplified, false))
+		{
+			m_eliminatedNodes += parts.second;
+			return Expression(false);
+		}
+		if (!simplified.identical(conjunct))
+			changed = true;
+		if (!isBoolLiteral(simplified, true) && keptSet.insert(simplified).second)
+			kept.emplace_back(simplified);
+	}
+	// The rebuilt conjunction consists of one conjunction less than it has conjuncts.
+	size_t conjunctions = kept.empty() ? 0 : kept.size() - 1;
+	if (!changed && conjunctions == parts.second)
+		return _conjunction;
+
+	m_eliminatedNodes += parts.second - conjunctions;
+	if (kept.empty())
+		return Expression(true);
+	Expression result = kept.front();
+	for (size_t i = 1; i < kept.size(); ++i)
+		result = result && kept[i];
+	return result;
+}
@@ -0,0 +1,76 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Local simplification and constant folding of SMT formulas.
+ */
+
+#pragma once
+
+#include <libsolidity/formal/SolverInterface.h>
+
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+namespace smt
+{
+
+/**
+ * Simplifies formulas by local rewrites that do not need a solver.
+ *
+ * The rewrites include
+ *  - folding operations on literals, e.g. `1 + 2` or `3 < 2`,
+ *  - neutral and absorbing elements, e.g. `x + 0`, `x * 0`, `x or true`,
+ *  - conditionals with a literal condition or equal branches, e.g. `ite(true, a, b)`,
+ *  - comparisons of identical expressions, e.g. `x_1 = x_1`,
+ *  - duplicate and `true` conjuncts of conjunctions, which occur for example
+ *    for the range constraints of SSA variables that are added again on every
+ *    branch merge.
+ *
+ * The simplified formula is equivalent to the original one, so its models are
+ * models of the original formula.
+ * The results are cached until clearCache is called, so that the parts that are
+ * shared by multiple formulas are only simplified once.
+ */
+class ExpressionSimplifier
+{
+public:
+	Expression simplify(Expression const& _formula);
+
+	/// @returns the number of operations that were removed from the simplified formulas
+	/// so far. Operations that are shared by multiple formulas are only counted once.
+	size_t eliminatedNodes() const { return m_eliminatedNodes; }
+
+	void clearCache() { m_simplified.clear(); }
+
+private:
+	/// @returns the simplification of @a _expression, whose arguments were simplified
+	/// to @a _arguments. Must not be called for conjunctions.
+	Expression simplifyNode(Expression const& _expression, std::vector<Expression> _arguments);
+	/// @returns the simplification of the conjunction @a _conjunction, whose conjuncts
+	/// were already simplified.
+	Expression simplifyConjunction(Expression const& _conjunction);
+
+	ExpressionMap<Expression> m_simplified;
+	size_t m_eliminatedNodes = 0;
+};
+
+}
+}
+}
@@ -22,8 +22,12 @@ using namespace dev;
 using namespace langutil;
 using namespace dev::solidity;
 
-ModelChecker::ModelChecker(ErrorReporter& _errorReporter, map<h256, string> const& _smtlib2Responses):
-	m_bmc(m_context, _errorReporter, _smtlib2Responses),
+ModelChecker::ModelChecker(
+	ErrorReporter& _errorReporter,
+	map<h256, string> const& _smtlib2Responses,
+	ModelCheckerSettings _settings
+):
+	m_bmc(m_context, _errorReporter, _smtlib2Responses, std::move(_settings)),
 	m_context(m_bmc.solver())
 {
 }
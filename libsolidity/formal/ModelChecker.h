@@ -24,6 +24,7 @@
 
 #include <libsolidity/formal/BMC.h>
 #include <libsolidity/formal/EncodingContext.h>
+#include <libsolidity/formal/ModelCheckerSettings.h>
 
 #include <libsolidity/interface/ReadFile.h>
 #include <liblangutil/ErrorReporter.h>
@@ -43,7 +44,11 @@ namespace solidity
 class ModelChecker
 {
 public:
-	ModelChecker(langutil::ErrorReporter& _errorReporter, std::map<h256, std::string> const& _smtlib2Responses);
+	ModelChecker(
+		langutil::ErrorReporter& _errorReporter,
+		std::map<h256, std::string> const& _smtlib2Responses,
+		ModelCheckerSettings _settings = ModelCheckerSettings{}
+	);
 
 	void analyze(SourceUnit const& _sources, std::shared_ptr<langutil::Scanner> const& _scanner);
 
@@ -52,6 +57,9 @@ public:
 	/// the constructor.
 	std::vector<std::string> unhandledQueries();
 
+	/// @returns the verification targets checked so far.
+	ModelCheckerReport const& report() const { return m_bmc.report(); }
+
 private:
 	/// Bounded Model Checker engine.
 	BMC m_bmc;
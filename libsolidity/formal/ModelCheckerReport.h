@@ -0,0 +1,57 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Report about the verification targets checked by the model checker.
+ */
+
+#pragma once
+
+#include <liblangutil/SourceLocation.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+
+struct VerificationTargetReport
+{
+	/// Name of the contract that was analyzed when the target was checked.
+	std::string contract;
+	langutil::SourceLocation location;
+	/// Kind of the target, e.g. "assert" or "overflow".
+	std::string kind;
+	/// Outcome of the check, e.g. "safe", "violated" or "unknown".
+	std::string result;
+	/// Solver that answered the (last) query of the target, "cache" if the answer
+	/// was cached and empty if no solver answered.
+	std::string solver;
+	/// Time spent on the queries of the target.
+	std::chrono::milliseconds time{0};
+	/// Number of nodes that were removed from the queries of the target by simplifying
+	/// them. Nodes shared with the queries of earlier targets of the same function are
+	/// only counted for the first one.
+	size_t eliminatedNodes = 0;
+};
+
+using ModelCheckerReport = std::vector<VerificationTargetReport>;
+
+}
+}
@@ -0,0 +1,63 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Settings of the model checking engines.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+
+struct ModelCheckerSettings
+{
+	/// Number of threads that check the verification targets of a function concurrently,
+	/// each with its own solvers. The targets are checked sequentially if it is 1.
+	unsigned workers = 1;
+	/// Directory in which the results of SMT queries are cached across compilations.
+	/// No results are cached if it is empty.
+	std::string cacheDirectory;
+	/// Command line of an SMT-LIB2 solver that reads commands from its standard input
+	/// (see smt::SolverProcess). The solver is queried in addition to the integrated
+	/// solvers, so that no query responses are needed if there are none.
+	std::vector<std::string> solverCommand;
+	/// Time in milliseconds the solvers may spend on each verification target, unlimited if zero.
+	unsigned targetTimeout = 10000;
+	/// Time in milliseconds the model checker may spend on each contract, unlimited if zero.
+	/// The targets that are not checked within this time are reported as not checked.
+	unsigned contractTimeout = 0;
+	/// Point in time after which no verification targets are checked anymore, in any contract.
+	/// The targets are reported as not checked, like those exceeding contractTimeout.
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+	/// Memory in megabytes the solvers may use for a query, unlimited if zero.
+	/// Only supported by Z3.
+	unsigned memoryLimit = 0;
+	/// If true, calls to internal pure and view functions are inlined like other internal
+	/// calls, so that the targets in the called functions are checked for every call.
+	/// Otherwise, their encodings are computed once and instantiated for every call
+	/// (see BMC::summarizeFunction).
+	bool inlineFunctionCalls = false;
+};
+
+}
+}
@@ -0,0 +1,92 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/formal/SMTCache.h>
+
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/JSON.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity::smt;
+
+SMTCache::SMTCache(string _directory):
+	m_directory(move(_directory))
+{
+	boost::system::error_code error;
+	boost::filesystem::create_directories(m_directory, error);
+}
+
+boost::optional<pair<CheckResult, vector<string>>> SMTCache::lookup(h256 const& _query) const
+{
+	string entry = readFileAsString(path(_query));
+	Json::Value json;
+	if (entry.empty() || !jsonParseStrict(entry, json) || !json["result"].isString() || !json["values"].isArray())
+		return boost::none;
+
+	CheckResult result;
+	if (json["result"].asString() == "sat")
+		result = CheckResult::SATISFIABLE;
+	else if (json["result"].asString() == "unsat")
+		result = CheckResult::UNSATISFIABLE;
+	else
+		return boost::none;
+	vector<string> values;
+	for (auto const& value: json["values"])
+	{
+		if (!value.isString())
+			return boost::none;
+		values.emplace_back(value.asString());
+	}
+	return make_pair(result, move(values));
+}
+
+void SMTCache::store(h256 const& _query, CheckResult _result, vector<string> const& _values) const
+{
+	if (_result != CheckResult::SATISFIABLE && _result != CheckResult::UNSATISFIABLE)
+		return;
+
+	Json::Value json{Json::objectValue};
+	json["result"] = _result == CheckResult::SATISFIABLE ? "sat" : "unsat";
+	json["values"] = Json::arrayValue;
+	for (auto const& value: _values)
+		json["values"].append(value);
+
+	// Writes to a temporary file first, so that concurrent readers never see partial entries.
+	boost::system::error_code error;
+	boost::filesystem::path temporary = boost::filesystem::unique_path(path(_query) + "-%%%%%%%%", error);
+	if (error)
+		return;
+	{
+		ofstream file(temporary.string(), ios::binary);
+		file << jsonCompactPrint(json);
+		if (!file)
+			return;
+	}
+	boost::filesystem::rename(temporary, path(_query), error);
+	if (error)
+		boost::filesystem::remove(temporary, error);
+}
+
+string SMTCache::path(h256 const& _query) const
+{
+	return (boost::filesystem::path(m_directory) / _query.hex()).string();
+}
@@ -0,0 +1,66 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Persistent cache of the results of SMT queries.
+ */
+
+#pragma once
+
+#include <libsolidity/formal/SolverInterface.h>
+
+#include <libdevcore/FixedHash.h>
+
+#include <boost/optional.hpp>
+
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+namespace smt
+{
+
+/**
+ * Stores the results of SMT queries in a directory, one file per query, so that
+ * they can be reused by later compilations.
+ * The queries are identified by a hash that has to include everything the
+ * result depends on, usually the query itself and the solvers.
+ * Only answers (SAT or UNSAT) are stored, since UNKNOWN usually means that
+ * the solver ran out of time.
+ *
+ * Errors accessing the directory are ignored, so they only lead to cache misses.
+ * Can be used concurrently from multiple threads and processes.
+ */
+class SMTCache
+{
+public:
+	explicit SMTCache(std::string _directory);
+
+	boost::optional<std::pair<CheckResult, std::vector<std::string>>> lookup(h256 const& _query) const;
+	void store(h256 const& _query, CheckResult _result, std::vector<std::string> const& _values) const;
+
+private:
+	std::string path(h256 const& _query) const;
+
+	std::string m_directory;
+};
+
+}
+}
+}
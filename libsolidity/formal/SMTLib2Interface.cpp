@@ -26,9 +26,14 @@
 #include <boost/filesystem/operations.hpp>
 
 #include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 
@@ -37,17 +42,55 @@ using namespace dev;
 using namespace dev::solidity;
 using namespace dev::solidity::smt;
 
-SMTLib2Interface::SMTLib2Interface(map<h256, string> const& _queryResponses):
-	m_queryResponses(_queryResponses)
+namespace
+{
+
+/// Used for commands that are sent outside of queries, which are not interrupted.
+atomic<bool> const notInterrupted{false};
+
+/// @returns the response of the solver started by @a _command to `(get-info :version)`
+/// or an empty string if it does not respond. Every command is only asked once.
+string solverVersion(vector<string> const& _command)
+{
+	static mutex versionsMutex;
+	static map<vector<string>, string> versions;
+	lock_guard<mutex> lock(versionsMutex);
+	auto version = versions.find(_command);
+	if (version != versions.end())
+		return version->second;
+
+	string response;
+	try
+	{
+		SolverProcess process(_command);
+		auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+		if (process.write("(get-info :version)\n", deadline, notInterrupted))
+			if (auto result = process.read(deadline, notInterrupted))
+				if (!boost::starts_with(*result, "(error"))
+					response = *result;
+	}
+	catch (SolverError const&)
+	{
+	}
+	return versions[_command] = response;
+}
+
+}
+
+SMTLib2Interface::SMTLib2Interface(map<h256, string> const& _queryResponses, vector<string> _solverCommand):
+	m_queryResponses(_queryResponses),
+	m_solverCommand(move(_solverCommand))
 {
 	reset();
 }
 
 void SMTLib2Interface::reset()
 {
+	m_solverProcess.reset();
 	m_accumulatedOutput.clear();
 	m_accumulatedOutput.emplace_back();
 	m_variables.clear();
+	m_translatedExpressions.clear();
 	write("(set-option :produce-models true)");
 	write("(set-logic QF_UFLIA)");
 }
@@ -55,12 +98,14 @@ void SMTLib2Interface::reset()
 void SMTLib2Interface::push()
 {
 	m_accumulatedOutput.emplace_back();
+	writeToSolverProcess("(push 1)\n");
 }
 
 void SMTLib2Interface::pop()
 {
 	solAssert(!m_accumulatedOutput.empty(), "");
 	m_accumulatedOutput.pop_back();
+	writeToSolverProcess("(pop 1)\n");
 }
 
 void SMTLib2Interface::declareVariable(string const& _name, Sort const& _sort)
@@ -103,37 +148,101 @@ void SMTLib2Interface::addAssertion(Expression const& _expr)
 
 pair<CheckResult, vector<string>> SMTLib2Interface::check(vector<Expression> const& _expressionsToEvaluate)
 {
-	string response = querySolver(
-		boost::algorithm::join(m_accumulatedOutput, "\n") +
-		checkSatAndGetValuesCommand(_expressionsToEvaluate)
-	);
+	string response =
+		hasSolverProcess() ?
+		querySolverProcess(_expressionsToEvaluate) :
+		querySolver(checkQuery({}, _expressionsToEvaluate));
+	return parseResponse(response, _expressionsToEvaluate);
+}
 
+pair<CheckResult, vector<string>> SMTLib2Interface::checkPreparedQuery(
+	string const& _query,
+	vector<Expression> const& _assumptions,
+	vector<Expression> const& _expressionsToEvaluate
+)
+{
+	// The solver process receives the commands incrementally instead.
+	if (hasSolverProcess())
+		return checkAssuming(_assumptions, _expressionsToEvaluate);
+	return parseResponse(querySolver(_query), _expressionsToEvaluate);
+}
+
+pair<CheckResult, vector<string>> SMTLib2Interface::parseResponse(string const& _response, vector<Expression> const& _expressionsToEvaluate)
+{
 	CheckResult result;
 	// TODO proper parsing
-	if (boost::starts_with(response, "sat\n"))
+	if (boost::starts_with(_response, "sat\n"))
 		result = CheckResult::SATISFIABLE;
-	else if (boost::starts_with(response, "unsat\n"))
+	else if (boost::starts_with(_response, "unsat\n"))
 		result = CheckResult::UNSATISFIABLE;
-	else if (boost::starts_with(response, "unknown\n"))
+	else if (boost::starts_with(_response, "unknown\n"))
 		result = CheckResult::UNKNOWN;
 	else
 		result = CheckResult::ERROR;
 
 	vector<string> values;
-	if (result == CheckResult::SATISFIABLE && result != CheckResult::ERROR)
-		values = parseValues(find(response.cbegin(), response.cend(), '\n'), response.cend());
+	if (result == CheckResult::SATISFIABLE && !_expressionsToEvaluate.empty())
+		values = parseValues(find(_response.cbegin(), _response.cend(), '\n'), _response.cend());
 	return make_pair(result, values);
 }
 
-string SMTLib2Interface::toSExpr(Expression const& _expr)
+string SMTLib2Interface::checkQuery(vector<Expression> const& _assumptions, vector<Expression> const& _expressionsToEvaluate)
+{
+	string query = boost::algorithm::join(m_accumulatedOutput, "\n");
+	// The assumptions are asserted in a scope of their own (see SolverInterface::checkAssuming).
+	if (!_assumptions.empty())
+	{
+		query += "\n";
+		for (Expression const& assumption: _assumptions)
+			query += "(assert " + toSExpr(assumption) + ")\n";
+	}
+	return query + checkSatAndGetValuesCommand(_expressionsToEvaluate);
+}
+
+string SMTLib2Interface::identity() const
 {
-	if (_expr.arguments.empty())
-		return _expr.name;
-	std::string sexpr = "(" + _expr.name;
-	for (auto const& arg: _expr.arguments)
+	if (!hasSolverProcess())
+		return {};
+	// The command alone does not tell which version of the solver is run.
+	string version = solverVersion(m_solverCommand);
+	if (version.empty())
+		return {};
+	return "smtlib2 " + boost::algorithm::join(m_solverCommand, " ") + " " + version;
+}
+
+string const& SMTLib2Interface::toSExpr(Expression const& _expr)
+{
+	bool symbol = _expr.op() == Operator::Variable || _expr.op() == Operator::Application;
+	bool negativeNumber = _expr.op() == Operator::Literal && boost::starts_with(_expr.name(), "-");
+	if (_expr.arguments().empty() && !negativeNumber && (!symbol || isSimpleSymbol(_expr.name())))
+		return _expr.name();
+	auto it = m_translatedExpressions.find(_expr);
+	if (it != m_translatedExpressions.end())
+		return it->second;
+
+	string name = _expr.name();
+	if (negativeNumber)
+		return m_translatedExpressions.emplace(_expr, "(- " + name.substr(1) + ")").first->second;
+	if (symbol && !isSimpleSymbol(name))
+		name = "|" + name + "|";
+	if (_expr.arguments().empty())
+		return m_translatedExpressions.emplace(_expr, move(name)).first->second;
+	std::string sexpr = "(" + name;
+	for (auto const& arg: _expr.arguments())
 		sexpr += " " + toSExpr(arg);
 	sexpr += ")";
-	return sexpr;
+	return m_translatedExpressions.emplace(_expr, move(sexpr)).first->second;
+}
+
+bool SMTLib2Interface::isSimpleSymbol(string const& _name)
+{
+	if (_name.empty() || isdigit(_name.front()))
+		return false;
+	static string const otherCharacters = "~!@$%^&*_-+=<>.?/";
+	for (char c: _name)
+		if (!isalnum(c) && otherCharacters.find(c) == string::npos)
+			return false;
+	return true;
 }
 
 string SMTLib2Interface::toSmtLibSort(Sort const& _sort)
@@ -166,43 +275,73 @@ string SMTLib2Interface::toSmtLibSort(vector<SortPointer> const& _sorts)
 void SMTLib2Interface::write(string _data)
 {
 	solAssert(!m_accumulatedOutput.empty(), "");
-	m_accumulatedOutput.back() += move(_data) + "\n";
+	m_accumulatedOutput.back() += _data + "\n";
+	writeToSolverProcess(_data + "\n");
+}
+
+void SMTLib2Interface::writeToSolverProcess(string const& _commands)
+{
+	if (!m_solverProcess)
+		return;
+	try
+	{
+		if (m_solverProcess->write(_commands, chrono::steady_clock::time_point::max(), notInterrupted))
+			return;
+	}
+	catch (SolverError const&)
+	{
+	}
+	// The process is restarted with the accumulated output by the next query.
+	m_solverProcess.reset();
 }
 
 string SMTLib2Interface::checkSatAndGetValuesCommand(vector<Expression> const& _expressionsToEvaluate)
+{
+	string command = evaluationCommands(_expressionsToEvaluate) + "(check-sat)\n";
+	if (!_expressionsToEvaluate.empty())
+		command += getValuesCommand(_expressionsToEvaluate);
+	return command;
+}
+
+string SMTLib2Interface::evaluationCommands(vector<Expression> const& _expressionsToEvaluate)
 {
 	string command;
-	if (_expressionsToEvaluate.empty())
-		command = "(check-sat)\n";
-	else
+	// TODO make sure these are unique
+	for (size_t i = 0; i < _expressionsToEvaluate.size(); i++)
 	{
-		// TODO make sure these are unique
-		for (size_t i = 0; i < _expressionsToEvaluate.size(); i++)
-		{
-			auto const& e = _expressionsToEvaluate.at(i);
-			solAssert(e.sort->kind == Kind::Int || e.sort->kind == Kind::Bool, "Invalid sort for expression to evaluate.");
-			command += "(declare-const |EVALEXPR_" + to_string(i) + "| " + (e.sort->kind == Kind::Int ? "Int" : "Bool") + ")\n";
-			command += "(assert (= |EVALEXPR_" + to_string(i) + "| " + toSExpr(e) + "))\n";
-		}
-		command += "(check-sat)\n";
-		command += "(get-value (";
-		for (size_t i = 0; i < _expressionsToEvaluate.size(); i++)
-			command += "|EVALEXPR_" + to_string(i) + "| ";
-		command += "))\n";
+		auto const& e = _expressionsToEvaluate.at(i);
+		solAssert(e.sort()->kind == Kind::Int || e.sort()->kind == Kind::Bool, "Invalid sort for expression to evaluate.");
+		command += "(declare-const |EVALEXPR_" + to_string(i) + "| " + (e.sort()->kind == Kind::Int ? "Int" : "Bool") + ")\n";
+		command += "(assert (= |EVALEXPR_" + to_string(i) + "| " + toSExpr(e) + "))\n";
 	}
+	return command;
+}
 
+string SMTLib2Interface::getValuesCommand(vector<Expression> const& _expressionsToEvaluate)
+{
+	string command = "(get-value (";
+	for (size_t i = 0; i < _expressionsToEvaluate.size(); i++)
+		command += "|EVALEXPR_" + to_string(i) + "| ";
+	command += "))\n";
 	return command;
 }
 
 vector<string> SMTLib2Interface::parseValues(string::const_iterator _start, string::const_iterator _end)
 {
+	// The values are given as a list of pairs of the evaluated symbol and its value,
+	// where the value can be a parenthesized expression like `(- 1)`.
 	vector<string> values;
 	while (_start < _end)
 	{
 		auto valStart = find(_start, _end, ' ');
 		if (valStart < _end)
 			++valStart;
-		auto valEnd = find(valStart, _end, ')');
+		auto valEnd = valStart;
+		for (size_t depth = 0; valEnd < _end && (depth > 0 || *valEnd != ')'); ++valEnd)
+			if (*valEnd == '(')
+				++depth;
+			else if (*valEnd == ')')
+				--depth;
 		values.emplace_back(valStart, valEnd);
 		_start = find(valEnd, _end, '(');
 	}
@@ -221,3 +360,57 @@ string SMTLib2Interface::querySolver(string const& _input)
 		return "unknown\n";
 	}
 }
+
+string SMTLib2Interface::querySolverProcess(vector<Expression> const& _expressionsToEvaluate)
+{
+	try
+	{
+		auto deadline =
+			m_queryTimeout ?
+			chrono::steady_clock::now() + chrono::milliseconds(m_queryTimeout) :
+			chrono::steady_clock::time_point::max();
+		bool sent = true;
+		if (!m_solverProcess)
+		{
+			m_solverProcess = make_unique<SolverProcess>(m_solverCommand);
+			for (size_t i = 0; sent && i < m_accumulatedOutput.size(); ++i)
+				sent = m_solverProcess->write((i > 0 ? "(push 1)\n" : "") + m_accumulatedOutput[i], deadline, m_interrupted);
+		}
+
+		// The expressions to evaluate are declared in a scope of their own,
+		// so that they can be declared again by the next query.
+		boost::optional<string> result;
+		if (sent && m_solverProcess->write(
+			"(push 1)\n" + evaluationCommands(_expressionsToEvaluate) + "(check-sat)\n",
+			deadline,
+			m_interrupted
+		))
+			result = m_solverProcess->read(deadline, m_interrupted);
+		string response;
+		if (result && *result == "sat" && !_expressionsToEvaluate.empty())
+		{
+			if (m_solverProcess->write(getValuesCommand(_expressionsToEvaluate), deadline, m_interrupted))
+				if (auto values = m_solverProcess->read(deadline, m_interrupted))
+					response = *result + "\n" + *values + "\n";
+		}
+		else if (result)
+			response = *result + "\n";
+
+		if (response.empty())
+		{
+			// The solver did not receive all commands or is still busy,
+			// so it cannot be used for the next query.
+			m_solverProcess.reset();
+			return "unknown\n";
+		}
+		if (boost::starts_with(response, "(error"))
+			BOOST_THROW_EXCEPTION(SolverError() << errinfo_comment(response));
+		writeToSolverProcess("(pop 1)\n");
+		return response;
+	}
+	catch (SolverError const&)
+	{
+		m_solverProcess.reset();
+		throw;
+	}
+}
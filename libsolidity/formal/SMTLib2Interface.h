@@ -18,6 +18,7 @@
 #pragma once
 
 #include <libsolidity/formal/SolverInterface.h>
+#include <libsolidity/formal/SolverProcess.h>
 
 #include <libsolidity/interface/ReadFile.h>
 #include <liblangutil/Exceptions.h>
@@ -25,8 +26,10 @@
 #include <libdevcore/FixedHash.h>
 
 #include <boost/noncopyable.hpp>
+#include <atomic>
 #include <cstdio>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -38,10 +41,19 @@ namespace solidity
 namespace smt
 {
 
+/**
+ * Translates the queries to SMT-LIB2. If a solver command is given, they are sent
+ * incrementally to a solver process (see SolverProcess), which is restarted if it
+ * does not answer a query within the timeout. Otherwise, their responses are taken
+ * from the given query responses and the unanswered queries are collected.
+ */
 class SMTLib2Interface: public SolverInterface, public boost::noncopyable
 {
 public:
-	explicit SMTLib2Interface(std::map<h256, std::string> const& _queryResponses);
+	explicit SMTLib2Interface(
+		std::map<h256, std::string> const& _queryResponses,
+		std::vector<std::string> _solverCommand = {}
+	);
 
 	void reset() override;
 
@@ -53,28 +65,70 @@ public:
 	void addAssertion(Expression const& _expr) override;
 	std::pair<CheckResult, std::vector<std::string>> check(std::vector<Expression> const& _expressionsToEvaluate) override;
 
+	void interrupt() override { m_interrupted = true; }
+	void resetInterrupt() override { m_interrupted = false; }
+
 	std::vector<std::string> unhandledQueries() override { return m_unhandledQueries; }
+	/// @returns the solver command and the version the solver reports if there is one,
+	/// which identify the results of its queries in the SMTCache.
+	std::string identity() const override;
+
+	/// @returns true if the queries are answered by a solver process.
+	bool hasSolverProcess() const { return !m_solverCommand.empty(); }
+
+	/// @returns the input to the solver for a call to checkAssuming with the same arguments.
+	std::string checkQuery(std::vector<Expression> const& _assumptions, std::vector<Expression> const& _expressionsToEvaluate);
+	/// Like checkAssuming, but takes the input to the solver from @a _query, which has to be
+	/// the result of checkQuery with the same arguments, instead of building it again.
+	std::pair<CheckResult, std::vector<std::string>> checkPreparedQuery(
+		std::string const& _query,
+		std::vector<Expression> const& _assumptions,
+		std::vector<Expression> const& _expressionsToEvaluate
+	);
 
 private:
 	void declareFunction(std::string const&, Sort const&);
 
-	std::string toSExpr(Expression const& _expr);
+	/// @returns the s-expression of @a _expr, which is only computed once per expression.
+	std::string const& toSExpr(Expression const& _expr);
+	/// @returns true if @a _name can be used as a symbol without quoting it.
+	static bool isSimpleSymbol(std::string const& _name);
 	std::string toSmtLibSort(Sort const& _sort);
 	std::string toSmtLibSort(std::vector<SortPointer> const& _sort);
 
 	void write(std::string _data);
+	/// Sends @a _commands to the solver process if it is running.
+	void writeToSolverProcess(std::string const& _commands);
 
 	std::string checkSatAndGetValuesCommand(std::vector<Expression> const& _expressionsToEvaluate);
+	/// @returns the commands that declare variables for the expressions to evaluate.
+	std::string evaluationCommands(std::vector<Expression> const& _expressionsToEvaluate);
+	std::string getValuesCommand(std::vector<Expression> const& _expressionsToEvaluate);
+	/// @returns the result and the values of the expressions to evaluate in @a _response.
+	std::pair<CheckResult, std::vector<std::string>> parseResponse(
+		std::string const& _response,
+		std::vector<Expression> const& _expressionsToEvaluate
+	);
 	std::vector<std::string> parseValues(std::string::const_iterator _start, std::string::const_iterator _end);
 
 	/// Communicates with the solver via the callback. Throws SMTSolverError on error.
 	std::string querySolver(std::string const& _input);
+	/// Communicates with the solver process, starting it if necessary.
+	/// @returns its responses in the same format as the query responses.
+	/// Throws SMTSolverError on error.
+	std::string querySolverProcess(std::vector<Expression> const& _expressionsToEvaluate);
 
 	std::vector<std::string> m_accumulatedOutput;
 	std::set<std::string> m_variables;
+	ExpressionMap<std::string> m_translatedExpressions;
 
 	std::map<h256, std::string> const& m_queryResponses;
 	std::vector<std::string> m_unhandledQueries;
+
+	std::vector<std::string> m_solverCommand;
+	/// Solver process whose state corresponds to m_accumulatedOutput, started on demand.
+	std::unique_ptr<SolverProcess> m_solverProcess;
+	std::atomic<bool> m_interrupted{false};
 };
 
 }
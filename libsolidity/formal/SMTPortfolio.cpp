@@ -25,14 +25,39 @@
 #endif
 #include <libsolidity/formal/SMTLib2Interface.h>
 
+#include <libdevcore/Keccak256.h>
+
+#include <future>
+
 using namespace std;
 using namespace dev;
 using namespace dev::solidity;
 using namespace dev::solidity::smt;
 
-SMTPortfolio::SMTPortfolio(map<h256, string> const& _smtlib2Responses)
+namespace
+{
+
+/// @returns a copy of @a _sort that shares the sorts it is composed of.
+SortPointer copySort(Sort const& _sort)
 {
-	m_solvers.emplace_back(make_unique<smt::SMTLib2Interface>(_smtlib2Responses));
+	if (auto functionSort = dynamic_cast<FunctionSort const*>(&_sort))
+		return make_shared<FunctionSort>(*functionSort);
+	else if (auto arraySort = dynamic_cast<ArraySort const*>(&_sort))
+		return make_shared<ArraySort>(*arraySort);
+	else
+		return make_shared<Sort>(_sort.kind);
+}
+
+}
+
+SMTPortfolio::SMTPortfolio(
+	map<h256, string> const& _smtlib2Responses,
+	shared_ptr<SMTCache> _cache,
+	vector<string> _solverCommand
+):
+	m_cache(move(_cache))
+{
+	m_solvers.emplace_back(make_unique<smt::SMTLib2Interface>(_smtlib2Responses, move(_solverCommand)));
 #ifdef HAVE_Z3
 	m_solvers.emplace_back(make_unique<smt::Z3Interface>());
 #endif
@@ -45,30 +70,85 @@ void SMTPortfolio::reset()
 {
 	for (auto const& s: m_solvers)
 		s->reset();
+	m_declarations.clear();
+	m_assertions = {{}};
+	++m_resets;
 }
 
 void SMTPortfolio::push()
 {
 	for (auto const& s: m_solvers)
 		s->push();
+	m_assertions.emplace_back();
 }
 
 void SMTPortfolio::pop()
 {
 	for (auto const& s: m_solvers)
 		s->pop();
+	solAssert(m_assertions.size() > 1, "");
+	m_assertions.pop_back();
 }
 
 void SMTPortfolio::declareVariable(string const& _name, Sort const& _sort)
 {
 	for (auto const& s: m_solvers)
 		s->declareVariable(_name, _sort);
+	m_declarations.emplace_back(_name, copySort(_sort));
 }
 
 void SMTPortfolio::addAssertion(Expression const& _expr)
 {
 	for (auto const& s: m_solvers)
 		s->addAssertion(_expr);
+	m_assertions.back().emplace_back(_expr);
+}
+
+void SMTPortfolio::synchronizeWith(SMTPortfolio const& _other)
+{
+	solAssert(m_assertions.size() == 1 && _other.m_assertions.size() == 1, "");
+	if (m_synchronizedResets != _other.m_resets)
+	{
+		reset();
+		m_synchronizedResets = _other.m_resets;
+	}
+	solAssert(m_declarations.size() <= _other.m_declarations.size(), "");
+	solAssert(m_assertions.front().size() <= _other.m_assertions.front().size(), "");
+	for (size_t i = m_declarations.size(); i < _other.m_declarations.size(); ++i)
+		declareVariable(_other.m_declarations[i].first, *_other.m_declarations[i].second);
+	for (size_t i = m_assertions.front().size(); i < _other.m_assertions.front().size(); ++i)
+		addAssertion(_other.m_assertions.front()[i]);
+}
+
+pair<CheckResult, vector<string>> SMTPortfolio::check(vector<Expression> const& _expressionsToEvaluate)
+{
+	return checkAssuming({}, _expressionsToEvaluate);
+}
+
+pair<CheckResult, vector<string>> SMTPortfolio::checkAssuming(
+	vector<Expression> const& _assumptions,
+	vector<Expression> const& _expressionsToEvaluate
+)
+{
+	// Without a solver, the results come from the SMT-LIB2 query responses.
+	string solverIdentity = identity();
+	if (!m_cache || solverIdentity.empty())
+		return checkAll(_assumptions, _expressionsToEvaluate);
+
+	// The SMT-LIB2 interface is the first solver and serializes the whole query.
+	auto smtlib2 = dynamic_cast<SMTLib2Interface*>(m_solvers.front().get());
+	solAssert(smtlib2, "");
+	string query = smtlib2->checkQuery(_assumptions, _expressionsToEvaluate);
+	h256 key = keccak256(solverIdentity + "\n" + query);
+	if (auto cached = m_cache->lookup(key))
+	{
+		m_answeringSolver = "cache";
+		return *cached;
+	}
+	// The query is reused instead of being built again.
+	auto result = checkAll(_assumptions, _expressionsToEvaluate, &query);
+	m_cache->store(key, result.first, result.second);
+	return result;
 }
 
 /*
@@ -100,26 +180,58 @@ void SMTPortfolio::addAssertion(Expression const& _expr)
  *   when it is told that this is a hard query to solve.
  *
  *   If all solvers return ERROR, the result is ERROR.
+ *
+ * The solvers are queried concurrently and the result is only decided after all of them
+ * have finished, each within its own timeout, so that conflicting answers are always detected.
+ * The values of the expressions to evaluate are taken from the first solver that answered
+ * in the order of m_solvers, not in the order of completion, so that they do not depend
+ * on the timing of the solvers.
 */
-pair<CheckResult, vector<string>> SMTPortfolio::check(vector<Expression> const& _expressionsToEvaluate)
+pair<CheckResult, vector<string>> SMTPortfolio::checkAll(
+	vector<Expression> const& _assumptions,
+	vector<Expression> const& _expressionsToEvaluate,
+	string const* _smtlib2Query
+)
 {
+	vector<pair<CheckResult, vector<string>>> results(m_solvers.size(), {CheckResult::ERROR, {}});
+
+	// Interrupts of the previous query must not abort this one.
+	for (auto const& s: m_solvers)
+		s->resetInterrupt();
+	// Each job only writes its own result, which is visible after the job was waited for.
+	vector<future<void>> jobs;
+	for (size_t i = 0; i < m_solvers.size(); ++i)
+		jobs.emplace_back(async(launch::async, [&, i]() {
+			// The SMT-LIB2 interface is the first solver (see the constructor).
+			results[i] =
+				i == 0 && _smtlib2Query ?
+				static_cast<SMTLib2Interface&>(*m_solvers[i]).checkPreparedQuery(*_smtlib2Query, _assumptions, _expressionsToEvaluate) :
+				m_solvers[i]->checkAssuming(_assumptions, _expressionsToEvaluate);
+		}));
+	// Waits for all solvers and re-throws their exceptions.
+	for (auto& job: jobs)
+		job.get();
+
 	CheckResult lastResult = CheckResult::ERROR;
 	vector<string> finalValues;
-	for (auto const& s: m_solvers)
+	m_answeringSolver.clear();
+	for (size_t i = 0; i < results.size(); ++i)
 	{
-		CheckResult result;
-		vector<string> values;
-		tie(result, values) = s->check(_expressionsToEvaluate);
+		CheckResult result = results[i].first;
 		if (solverAnswered(result))
 		{
 			if (!solverAnswered(lastResult))
 			{
 				lastResult = result;
-				finalValues = std::move(values);
+				finalValues = std::move(results[i].second);
+				m_answeringSolver = m_solvers[i]->identity();
+				if (m_answeringSolver.empty())
+					m_answeringSolver = "smtlib2";
 			}
 			else if (lastResult != result)
 			{
 				lastResult = CheckResult::CONFLICTING;
+				m_answeringSolver.clear();
 				break;
 			}
 		}
@@ -129,6 +241,32 @@ pair<CheckResult, vector<string>> SMTPortfolio::check(vector<Expression> const&
 	return make_pair(lastResult, finalValues);
 }
 
+void SMTPortfolio::interrupt()
+{
+	for (auto const& s: m_solvers)
+		s->interrupt();
+}
+
+void SMTPortfolio::setTimeout(unsigned _milliseconds)
+{
+	SolverInterface::setTimeout(_milliseconds);
+	for (auto const& s: m_solvers)
+		s->setTimeout(_milliseconds);
+}
+
+void SMTPortfolio::setMemoryLimit(unsigned _megabytes)
+{
+	for (auto const& s: m_solvers)
+		s->setMemoryLimit(_megabytes);
+}
+
+bool SMTPortfolio::hasSolver() const
+{
+	auto smtlib2 = dynamic_cast<SMTLib2Interface const*>(m_solvers.front().get());
+	solAssert(smtlib2, "");
+	return m_solvers.size() > 1 || smtlib2->hasSolverProcess();
+}
+
 vector<string> SMTPortfolio::unhandledQueries()
 {
 	// This code assumes that the constructor guarantees that
@@ -138,6 +276,18 @@ vector<string> SMTPortfolio::unhandledQueries()
 	return m_solvers.front()->unhandledQueries();
 }
 
+string SMTPortfolio::identity() const
+{
+	string result;
+	for (auto const& s: m_solvers)
+	{
+		string solverIdentity = s->identity();
+		if (!solverIdentity.empty())
+			result += (result.empty() ? "" : ", ") + solverIdentity;
+	}
+	return result;
+}
+
 bool SMTPortfolio::solverAnswered(CheckResult result)
 {
 	return result == CheckResult::SATISFIABLE || result == CheckResult::UNSATISFIABLE;
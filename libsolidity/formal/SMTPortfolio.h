@@ -18,6 +18,7 @@
 #pragma once
 
 
+#include <libsolidity/formal/SMTCache.h>
 #include <libsolidity/formal/SolverInterface.h>
 #include <libsolidity/interface/ReadFile.h>
 #include <libdevcore/FixedHash.h>
@@ -38,11 +39,19 @@ namespace smt
  * propagating the functionalities to all solvers.
  * It also checks whether different solvers give conflicting answers
  * to SMT queries.
+ * If a cache is given, the results of queries are taken from the cache if possible
+ * and stored in the cache otherwise.
+ * Records its declarations and assertions, so that other portfolios can be
+ * brought into the same state (see synchronizeWith).
  */
 class SMTPortfolio: public SolverInterface, public boost::noncopyable
 {
 public:
-	SMTPortfolio(std::map<h256, std::string> const& _smtlib2Responses);
+	SMTPortfolio(
+		std::map<h256, std::string> const& _smtlib2Responses,
+		std::shared_ptr<SMTCache> _cache = nullptr,
+		std::vector<std::string> _solverCommand = {}
+	);
 
 	void reset() override;
 
@@ -54,15 +63,55 @@ public:
 	void addAssertion(Expression const& _expr) override;
 
 	std::pair<CheckResult, std::vector<std::string>> check(std::vector<Expression> const& _expressionsToEvaluate) override;
+	std::pair<CheckResult, std::vector<std::string>> checkAssuming(
+		std::vector<Expression> const& _assumptions,
+		std::vector<Expression> const& _expressionsToEvaluate
+	) override;
+	void interrupt() override;
 
 	std::vector<std::string> unhandledQueries() override;
 	unsigned solvers() override { return m_solvers.size(); }
+	/// @returns the identities of all solvers that have one.
+	std::string identity() const override;
+	void setTimeout(unsigned _milliseconds) override;
+	void setMemoryLimit(unsigned _megabytes) override;
+	/// @returns false if no solver answers the queries, i.e. if they are only collected
+	/// by the SMT-LIB2 interface and answered by the given responses.
+	bool hasSolver() const;
+	/// @returns the name of the solver that answered the last query, "cache" if the
+	/// answer was taken from the cache and an empty string if no solver answered.
+	std::string const& answeringSolver() const { return m_answeringSolver; }
+
+	/// Declares the variables and adds the assertions of @a _other that this portfolio
+	/// does not have yet, resetting it first if @a _other was reset in the meantime.
+	/// Afterwards, both portfolios have the same state, provided that this portfolio
+	/// is only modified through this function.
+	/// Neither portfolio may have open scopes (from push).
+	void synchronizeWith(SMTPortfolio const& _other);
+	/// @returns the assertions of the outermost scope.
+	std::vector<Expression> const& assertions() const { return m_assertions.front(); }
+
 private:
+	/// Queries all solvers concurrently, see the implementation for how the results are combined.
+	/// @param _smtlib2Query the input to the SMT-LIB2 interface if it was already built.
+	std::pair<CheckResult, std::vector<std::string>> checkAll(
+		std::vector<Expression> const& _assumptions,
+		std::vector<Expression> const& _expressionsToEvaluate,
+		std::string const* _smtlib2Query = nullptr
+	);
 	static bool solverAnswered(CheckResult result);
 
 	std::vector<std::unique_ptr<smt::SolverInterface>> m_solvers;
-
-	std::vector<Expression> m_assertions;
+	std::shared_ptr<SMTCache> m_cache;
+
+	std::vector<std::pair<std::string, SortPointer>> m_declarations;
+	/// Assertions in the scopes opened by push, the first element is the outermost scope.
+	std::vector<std::vector<Expression>> m_assertions{{}};
+	/// Number of calls to reset, used to detect resets in synchronizeWith.
+	unsigned m_resets = 0;
+	/// Value of m_resets of the portfolio this one was last synchronized with.
+	unsigned m_synchronizedResets = 0;
+	std::string m_answeringSolver;
 };
 
 }
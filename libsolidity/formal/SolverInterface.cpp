@@ -0,0 +1,224 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/formal/SolverInterface.h>
+
+#include <boost/functional/hash.hpp>
+
+#include <functional>
+#include <mutex>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity::smt;
+
+namespace
+{
+
+/// Table of all existing expression nodes, indexed by their hash.
+/// Nodes remove themselves when they are destroyed.
+/// Can be accessed from multiple threads.
+class NodeTable
+{
+public:
+	static NodeTable& instance()
+	{
+		// Intentionally leaked, so that it outlives all static expressions.
+		static NodeTable* table = new NodeTable();
+		return *table;
+	}
+
+	shared_ptr<Expression::Node const> intern(Expression::Node _node)
+	{
+		// Keeps the candidates alive until the table is unlocked, since releasing
+		// the last reference to a node accesses the table.
+		vector<shared_ptr<Expression::Node const>> candidates;
+		lock_guard<mutex> lock(m_mutex);
+		auto range = m_nodes.equal_range(_node.hash);
+		for (auto it = range.first; it != range.second; ++it)
+			if (auto node = it->second.lock())
+			{
+				candidates.emplace_back(node);
+				if (equal(*node, _node))
+					return node;
+			}
+		shared_ptr<Expression::Node const> node(
+			new Expression::Node(std::move(_node)),
+			[](Expression::Node const* _n) { NodeTable::instance().release(_n); }
+		);
+		m_nodes.emplace(node->hash, node);
+		return node;
+	}
+
+private:
+	static bool equal(Expression::Node const& _a, Expression::Node const& _b)
+	{
+		if (
+			_a.op != _b.op ||
+			_a.name != _b.name ||
+			_a.arguments.size() != _b.arguments.size() ||
+			!(*_a.sort == *_b.sort)
+		)
+			return false;
+		for (size_t i = 0; i < _a.arguments.size(); ++i)
+			if (!_a.arguments[i].identical(_b.arguments[i]))
+				return false;
+		return true;
+	}
+
+	void release(Expression::Node const* _node)
+	{
+		{
+			lock_guard<mutex> lock(m_mutex);
+			// Another thread might have already replaced the entry, so only remove
+			// the ones that expired.
+			auto range = m_nodes.equal_range(_node->hash);
+			for (auto it = range.first; it != range.second;)
+				if (it->second.expired())
+					it = m_nodes.erase(it);
+				else
+					++it;
+		}
+		// Destroying the node releases its arguments, which accesses the table again.
+		delete _node;
+	}
+
+	mutex m_mutex;
+	unordered_multimap<size_t, weak_ptr<Expression::Node const>> m_nodes;
+};
+
+size_t hashNode(Operator _op, string const& _name, vector<Expression> const& _arguments, Sort const& _sort)
+{
+	size_t hash = static_cast<size_t>(_op);
+	boost::hash_combine(hash, _name);
+	for (auto const& argument: _arguments)
+		boost::hash_combine(hash, argument.hash());
+	boost::hash_combine(hash, static_cast<size_t>(_sort.kind));
+	return hash;
+}
+
+SortPointer const& basicSort(Kind _kind)
+{
+	static SortPointer const intSort = make_shared<Sort>(Kind::Int);
+	static SortPointer const boolSort = make_shared<Sort>(Kind::Bool);
+	solAssert(_kind == Kind::Int || _kind == Kind::Bool, "");
+	return _kind == Kind::Int ? intSort : boolSort;
+}
+
+string const& operatorName(Operator _op)
+{
+	static map<Operator, string> const names{
+		{Operator::Ite, "ite"},
+		{Operator::Not, "not"},
+		{Operator::And, "and"},
+		{Operator::Or, "or"},
+		{Operator::Implies, "implies"},
+		{Operator::Equal, "="},
+		{Operator::Less, "<"},
+		{Operator::LessOrEqual, "<="},
+		{Operator::Greater, ">"},
+		{Operator::GreaterOrEqual, ">="},
+		{Operator::Add, "+"},
+		{Operator::Sub, "-"},
+		{Operator::Mul, "*"},
+		{Operator::Div, "/"},
+		{Operator::Mod, "mod"},
+		{Operator::Select, "select"},
+		{Operator::Store, "store"}
+	};
+	solAssert(names.count(_op), "");
+	return names.at(_op);
+}
+
+}
+
+bool Expression::hasCorrectArity() const
+{
+	static map<Operator, unsigned> const operatorsArity{
+		{Operator::Ite, 3},
+		{Operator::Not, 1},
+		{Operator::And, 2},
+		{Operator::Or, 2},
+		{Operator::Implies, 2},
+		{Operator::Equal, 2},
+		{Operator::Less, 2},
+		{Operator::LessOrEqual, 2},
+		{Operator::Greater, 2},
+		{Operator::GreaterOrEqual, 2},
+		{Operator::Add, 2},
+		{Operator::Sub, 2},
+		{Operator::Mul, 2},
+		{Operator::Div, 2},
+		{Operator::Mod, 2},
+		{Operator::Select, 2},
+		{Operator::Store, 3}
+	};
+	return operatorsArity.count(op()) && operatorsArity.at(op()) == arguments().size();
+}
+
+Expression::Expression(Operator _op, string _name, vector<Expression> _arguments, SortPointer _sort)
+{
+	solAssert(_sort, "");
+	size_t hash = hashNode(_op, _name, _arguments, *_sort);
+	m_node = NodeTable::instance().intern(Node{_op, std::move(_name), std::move(_arguments), std::move(_sort), hash});
+}
+
+Expression::Expression(Operator _op, string _name, vector<Expression> _arguments, Kind _kind):
+	Expression(_op, std::move(_name), std::move(_arguments), basicSort(_kind))
+{
+}
+
+Expression::Expression(Operator _op, vector<Expression> _arguments, SortPointer _sort):
+	Expression(_op, operatorName(_op), std::move(_arguments), std::move(_sort))
+{
+}
+
+Expression::Expression(Operator _op, Expression _arg, Kind _kind):
+	Expression(_op, vector<Expression>{std::move(_arg)}, basicSort(_kind))
+{
+}
+
+Expression::Expression(Operator _op, Expression _arg1, Expression _arg2, Kind _kind):
+	Expression(_op, vector<Expression>{std::move(_arg1), std::move(_arg2)}, basicSort(_kind))
+{
+}
+
+Expression Expression::substitute(map<string, Expression> const& _substitution) const
+{
+	// Shared sub-expressions are only substituted once.
+	ExpressionMap<Expression> substituted;
+	function<Expression(Expression const&)> substituteIn = [&](Expression const& _expression)
+	{
+		if (_expression.op() == Operator::Variable)
+		{
+			auto it = _substitution.find(_expression.name());
+			return it == _substitution.end() ? _expression : it->second;
+		}
+		if (_expression.arguments().empty())
+			return _expression;
+		auto it = substituted.find(_expression);
+		if (it != substituted.end())
+			return it->second;
+		vector<Expression> arguments;
+		for (auto const& argument: _expression.arguments())
+			arguments.emplace_back(substituteIn(argument));
+		Expression result(_expression.op(), _expression.name(), std::move(arguments), _expression.sort());
+		substituted.emplace(_expression, result);
+		return result;
+	};
+	return substituteIn(*this);
+}
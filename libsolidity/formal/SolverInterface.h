@@ -26,6 +26,7 @@
 #include <cstdio>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace dev
@@ -110,51 +111,64 @@ struct ArraySort: public Sort
 	SortPointer range;
 };
 
+/// Operators of SMTLIB2 expressions. Literals, variables and applications of
+/// uninterpreted functions are further identified by the name of the expression.
+enum class Operator
+{
+	Literal,
+	Variable,
+	Application,
+	Ite,
+	Not,
+	And,
+	Or,
+	Implies,
+	Equal,
+	Less,
+	LessOrEqual,
+	Greater,
+	GreaterOrEqual,
+	Add,
+	Sub,
+	Mul,
+	Div,
+	Mod,
+	Select,
+	Store
+};
+
 /// C++ representation of an SMTLIB2 expression.
+///
+/// Expressions are immutable and hash-consed: an Expression is a reference to a node
+/// that is shared by all structurally equal expressions, so copying an expression
+/// is cheap and sub-expressions that occur multiple times (for example in the values
+/// of merged variables) are only stored once. This also allows the solver interfaces
+/// to translate every node only once (see ExpressionMap).
 class Expression
 {
 	friend class SolverInterface;
+	friend class ExpressionSimplifier;
 public:
-	explicit Expression(bool _v): Expression(_v ? "true" : "false", Kind::Bool) {}
-	Expression(size_t _number): Expression(std::to_string(_number), Kind::Int) {}
-	Expression(u256 const& _number): Expression(_number.str(), Kind::Int) {}
-	Expression(s256 const& _number): Expression(_number.str(), Kind::Int) {}
-	Expression(bigint const& _number): Expression(_number.str(), Kind::Int) {}
+	struct Node;
+
+	explicit Expression(bool _v): Expression(Operator::Literal, _v ? "true" : "false", {}, Kind::Bool) {}
+	Expression(size_t _number): Expression(Operator::Literal, std::to_string(_number), {}, Kind::Int) {}
+	Expression(u256 const& _number): Expression(Operator::Literal, _number.str(), {}, Kind::Int) {}
+	Expression(s256 const& _number): Expression(Operator::Literal, _number.str(), {}, Kind::Int) {}
+	Expression(bigint const& _number): Expression(Operator::Literal, _number.str(), {}, Kind::Int) {}
 
 	Expression(Expression const&) = default;
 	Expression(Expression&&) = default;
 	Expression& operator=(Expression const&) = default;
 	Expression& operator=(Expression&&) = default;
 
-	bool hasCorrectArity() const
-	{
-		static std::map<std::string, unsigned> const operatorsArity{
-			{"ite", 3},
-			{"not", 1},
-			{"and", 2},
-			{"or", 2},
-			{"implies", 2},
-			{"=", 2},
-			{"<", 2},
-			{"<=", 2},
-			{">", 2},
-			{">=", 2},
-			{"+", 2},
-			{"-", 2},
-			{"*", 2},
-			{"/", 2},
-			{"mod", 2},
-			{"select", 2},
-			{"store", 3}
-		};
-		return operatorsArity.count(name) && operatorsArity.at(name) == arguments.size();
-	}
+	bool hasCorrectArity() const;
 
 	static Expression ite(Expression _condition, Expression _trueValue, Expression _falseValue)
 	{
-		solAssert(*_trueValue.sort == *_falseValue.sort, "");
-		SortPointer sort = _trueValue.sort;
-		return Expression("ite", std::vector<Expression>{
+		solAssert(*_trueValue.sort() == *_falseValue.sort(), "");
+		SortPointer sort = _trueValue.sort();
+		return Expression(Operator::Ite, std::vector<Expression>{
 			std::move(_condition), std::move(_trueValue), std::move(_falseValue)
 		}, std::move(sort));
 	}
@@ -162,7 +176,7 @@ public:
 	static Expression implies(Expression _a, Expression _b)
 	{
 		return Expression(
-			"implies",
+			Operator::Implies,
 			std::move(_a),
 			std::move(_b),
 			Kind::Bool
@@ -172,13 +186,13 @@ public:
 	/// select is the SMT representation of an array index access.
 	static Expression select(Expression _array, Expression _index)
 	{
-		solAssert(_array.sort->kind == Kind::Array, "");
-		std::shared_ptr<ArraySort> arraySort = std::dynamic_pointer_cast<ArraySort>(_array.sort);
+		solAssert(_array.sort()->kind == Kind::Array, "");
+		std::shared_ptr<ArraySort> arraySort = std::dynamic_pointer_cast<ArraySort>(_array.sort());
 		solAssert(arraySort, "");
-		solAssert(_index.sort, "");
-		solAssert(*arraySort->domain == *_index.sort, "");
+		solAssert(_index.sort(), "");
+		solAssert(*arraySort->domain == *_index.sort(), "");
 		return Expression(
-			"select",
+			Operator::Select,
 			std::vector<Expression>{std::move(_array), std::move(_index)},
 			arraySort->range
 		);
@@ -188,15 +202,15 @@ public:
 	/// The function is pure and returns the modified array.
 	static Expression store(Expression _array, Expression _index, Expression _element)
 	{
-		solAssert(_array.sort->kind == Kind::Array, "");
-		std::shared_ptr<ArraySort> arraySort = std::dynamic_pointer_cast<ArraySort>(_array.sort);
+		solAssert(_array.sort()->kind == Kind::Array, "");
+		std::shared_ptr<ArraySort> arraySort = std::dynamic_pointer_cast<ArraySort>(_array.sort());
 		solAssert(arraySort, "");
-		solAssert(_index.sort, "");
-		solAssert(_element.sort, "");
-		solAssert(*arraySort->domain == *_index.sort, "");
-		solAssert(*arraySort->range == *_element.sort, "");
+		solAssert(_index.sort(), "");
+		solAssert(_element.sort(), "");
+		solAssert(*arraySort->domain == *_index.sort(), "");
+		solAssert(*arraySort->range == *_element.sort(), "");
 		return Expression(
-			"store",
+			Operator::Store,
 			std::vector<Expression>{std::move(_array), std::move(_index), std::move(_element)},
 			arraySort
 		);
@@ -204,19 +218,19 @@ public:
 
 	friend Expression operator!(Expression _a)
 	{
-		return Expression("not", std::move(_a), Kind::Bool);
+		return Expression(Operator::Not, std::move(_a), Kind::Bool);
 	}
 	friend Expression operator&&(Expression _a, Expression _b)
 	{
-		return Expression("and", std::move(_a), std::move(_b), Kind::Bool);
+		return Expression(Operator::And, std::move(_a), std::move(_b), Kind::Bool);
 	}
 	friend Expression operator||(Expression _a, Expression _b)
 	{
-		return Expression("or", std::move(_a), std::move(_b), Kind::Bool);
+		return Expression(Operator::Or, std::move(_a), std::move(_b), Kind::Bool);
 	}
 	friend Expression operator==(Expression _a, Expression _b)
 	{
-		return Expression("=", std::move(_a), std::move(_b), Kind::Bool);
+		return Expression(Operator::Equal, std::move(_a), std::move(_b), Kind::Bool);
 	}
 	friend Expression operator!=(Expression _a, Expression _b)
 	{
@@ -224,70 +238,112 @@ public:
 	}
 	friend Expression operator<(Expression _a, Expression _b)
 	{
-		return Expression("<", std::move(_a), std::move(_b), Kind::Bool);
+		return Expression(Operator::Less, std::move(_a), std::move(_b), Kind::Bool);
 	}
 	friend Expression operator<=(Expression _a, Expression _b)
 	{
-		return Expression("<=", std::move(_a), std::move(_b), Kind::Bool);
+		return Expression(Operator::LessOrEqual, std::move(_a), std::move(_b), Kind::Bool);
 	}
 	friend Expression operator>(Expression _a, Expression _b)
 	{
-		return Expression(">", std::move(_a), std::move(_b), Kind::Bool);
+		return Expression(Operator::Greater, std::move(_a), std::move(_b), Kind::Bool);
 	}
 	friend Expression operator>=(Expression _a, Expression _b)
 	{
-		return Expression(">=", std::move(_a), std::move(_b), Kind::Bool);
+		return Expression(Operator::GreaterOrEqual, std::move(_a), std::move(_b), Kind::Bool);
 	}
 	friend Expression operator+(Expression _a, Expression _b)
 	{
-		return Expression("+", std::move(_a), std::move(_b), Kind::Int);
+		return Expression(Operator::Add, std::move(_a), std::move(_b), Kind::Int);
 	}
 	friend Expression operator-(Expression _a, Expression _b)
 	{
-		return Expression("-", std::move(_a), std::move(_b), Kind::Int);
+		return Expression(Operator::Sub, std::move(_a), std::move(_b), Kind::Int);
 	}
 	friend Expression operator*(Expression _a, Expression _b)
 	{
-		return Expression("*", std::move(_a), std::move(_b), Kind::Int);
+		return Expression(Operator::Mul, std::move(_a), std::move(_b), Kind::Int);
 	}
 	friend Expression operator/(Expression _a, Expression _b)
 	{
-		return Expression("/", std::move(_a), std::move(_b), Kind::Int);
+		return Expression(Operator::Div, std::move(_a), std::move(_b), Kind::Int);
 	}
 	friend Expression operator%(Expression _a, Expression _b)
 	{
-		return Expression("mod", std::move(_a), std::move(_b), Kind::Int);
+		return Expression(Operator::Mod, std::move(_a), std::move(_b), Kind::Int);
 	}
 	Expression operator()(std::vector<Expression> _arguments) const
 	{
 		solAssert(
-			sort->kind == Kind::Function,
+			sort()->kind == Kind::Function,
 			"Attempted function application to non-function."
 		);
-		auto fSort = dynamic_cast<FunctionSort const*>(sort.get());
+		auto fSort = dynamic_cast<FunctionSort const*>(sort().get());
 		solAssert(fSort, "");
-		return Expression(name, std::move(_arguments), fSort->codomain);
+		return Expression(Operator::Application, name(), std::move(_arguments), fSort->codomain);
 	}
 
+	Operator op() const;
+	/// @returns the SMTLIB2 name of the operator or the name of the literal, variable or function.
+	std::string const& name() const;
+	std::vector<Expression> const& arguments() const;
+	SortPointer const& sort() const;
+
+	/// @returns true if this and @a _other are the same expression. Because of the
+	/// hash-consing, this is the case if and only if they are structurally equal.
+	/// Note that operator== creates an SMT equality instead.
+	bool identical(Expression const& _other) const { return m_node == _other.m_node; }
+	std::size_t hash() const;
+
+	/// @returns this expression with every variable replaced by the expression
+	/// @a _substitution maps its name to, if there is one.
+	Expression substitute(std::map<std::string, Expression> const& _substitution) const;
+
+private:
+	/// Manual constructors, should only be used by SolverInterface, ExpressionSimplifier
+	/// and this class itself.
+	/// They return the node for the expression if it already exists.
+	Expression(Operator _op, std::string _name, std::vector<Expression> _arguments, SortPointer _sort);
+	Expression(Operator _op, std::string _name, std::vector<Expression> _arguments, Kind _kind);
+
+	Expression(Operator _op, std::vector<Expression> _arguments, SortPointer _sort);
+	Expression(Operator _op, Expression _arg, Kind _kind);
+	Expression(Operator _op, Expression _arg1, Expression _arg2, Kind _kind);
+
+	std::shared_ptr<Node const> m_node;
+};
+
+struct Expression::Node
+{
+	Operator op;
 	std::string name;
 	std::vector<Expression> arguments;
 	SortPointer sort;
+	/// Hash of the above, where the arguments are identified by their nodes.
+	std::size_t hash;
+};
 
-private:
-	/// Manual constructors, should only be used by SolverInterface and this class itself.
-	Expression(std::string _name, std::vector<Expression> _arguments, SortPointer _sort):
-		name(std::move(_name)), arguments(std::move(_arguments)), sort(std::move(_sort)) {}
-	Expression(std::string _name, std::vector<Expression> _arguments, Kind _kind):
-		Expression(std::move(_name), std::move(_arguments), std::make_shared<Sort>(_kind)) {}
-
-	explicit Expression(std::string _name, Kind _kind):
-		Expression(std::move(_name), std::vector<Expression>{}, _kind) {}
-	Expression(std::string _name, Expression _arg, Kind _kind):
-		Expression(std::move(_name), std::vector<Expression>{std::move(_arg)}, _kind) {}
-	Expression(std::string _name, Expression _arg1, Expression _arg2, Kind _kind):
-		Expression(std::move(_name), std::vector<Expression>{std::move(_arg1), std::move(_arg2)}, _kind) {}
+inline Operator Expression::op() const { return m_node->op; }
+inline std::string const& Expression::name() const { return m_node->name; }
+inline std::vector<Expression> const& Expression::arguments() const { return m_node->arguments; }
+inline SortPointer const& Expression::sort() const { return m_node->sort; }
+inline std::size_t Expression::hash() const { return m_node->hash; }
+
+/// Hash and equality functions that identify expressions by their node.
+struct ExpressionHash
+{
+	std::size_t operator()(Expression const& _expression) const { return _expression.hash(); }
+};
+struct ExpressionIdentical
+{
+	bool operator()(Expression const& _a, Expression const& _b) const { return _a.identical(_b); }
 };
 
+/// Map from expressions to values, for example their translations for a solver.
+/// Keeps the expressions alive, so that their nodes are not reused for other expressions.
+template <class T>
+using ExpressionMap = std::unordered_map<Expression, T, ExpressionHash, ExpressionIdentical>;
+
 DEV_SIMPLE_EXCEPTION(SolverError);
 
 class SolverInterface
@@ -305,7 +361,7 @@ public:
 		// Subclasses should do something here
 		solAssert(_sort, "");
 		declareVariable(_name, *_sort);
-		return Expression(std::move(_name), {}, std::move(_sort));
+		return Expression(Operator::Variable, std::move(_name), {}, std::move(_sort));
 	}
 
 	virtual void addAssertion(Expression const& _expr) = 0;
@@ -315,15 +371,49 @@ public:
 	virtual std::pair<CheckResult, std::vector<std::string>>
 	check(std::vector<Expression> const& _expressionsToEvaluate) = 0;
 
+	/// Checks for satisfiability as check does, but with @a _assumptions holding
+	/// in addition to the assertions for this query only.
+	/// Solvers that support assumptions keep what they learned from the query,
+	/// the default implementation asserts the assumptions in a scope of their own.
+	virtual std::pair<CheckResult, std::vector<std::string>>
+	checkAssuming(std::vector<Expression> const& _assumptions, std::vector<Expression> const& _expressionsToEvaluate)
+	{
+		push();
+		ScopeGuard popScope([&]() { pop(); });
+		for (Expression const& assumption: _assumptions)
+			addAssertion(assumption);
+		return check(_expressionsToEvaluate);
+	}
+
+	/// Aborts a call to check that is running in another thread, which then returns UNKNOWN.
+	/// Has no effect if check is not running.
+	virtual void interrupt() {}
+	/// Undoes earlier calls to interrupt that did not abort a call to check.
+	/// Has to be called before check is started, by the thread that calls interrupt.
+	virtual void resetInterrupt() {}
+
 	/// @returns a list of queries that the system was not able to respond to.
 	virtual std::vector<std::string> unhandledQueries() { return {}; }
 
 	/// @returns how many SMT solvers this interface has.
 	virtual unsigned solvers() { return 1; }
 
+	/// @returns the name and version of the solver, which identify the results
+	/// of its queries in the SMTCache. Empty if the results should not be cached.
+	virtual std::string identity() const { return {}; }
+
+	/// Limits the time of the following queries to @a _milliseconds, zero meaning no limit.
+	virtual void setTimeout(unsigned _milliseconds) { m_queryTimeout = _milliseconds; }
+	/// Limits the memory the solver may use for the following queries to @a _megabytes,
+	/// zero meaning no limit. Ignored by solvers that do not support it.
+	virtual void setMemoryLimit(unsigned _megabytes) { (void)_megabytes; }
+
+	// Default SMT query timeout in milliseconds.
+	static unsigned const defaultQueryTimeout = 10000;
+
 protected:
-	// SMT query timeout in milliseconds.
-	static int const queryTimeout = 10000;
+	// SMT query timeout in milliseconds, zero meaning no limit.
+	unsigned m_queryTimeout = defaultQueryTimeout;
 };
 
 }
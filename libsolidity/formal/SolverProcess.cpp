@@ -0,0 +1,240 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/formal/SolverProcess.h>
+
+#include <libsolidity/formal/SolverInterface.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+extern char** environ;
+#endif
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity::smt;
+
+#ifdef _WIN32
+
+SolverProcess::SolverProcess(vector<string> const&)
+{
+	BOOST_THROW_EXCEPTION(SolverError() << errinfo_comment("SMT solver processes are not supported on Windows."));
+}
+
+SolverProcess::~SolverProcess() {}
+
+bool SolverProcess::write(string const&, chrono::steady_clock::time_point, atomic<bool> const&)
+{
+	return false;
+}
+
+boost::optional<string> SolverProcess::read(chrono::steady_clock::time_point, atomic<bool> const&)
+{
+	return boost::none;
+}
+
+#else
+
+SolverProcess::SolverProcess(vector<string> const& _command)
+{
+	solAssert(!_command.empty(), "");
+	int sockets[2];
+	// Other processes started concurrently must not inherit the sockets, so they
+	// are created with FD_CLOEXEC set where this is possible atomically.
+#ifdef SOCK_CLOEXEC
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0)
+		BOOST_THROW_EXCEPTION(SolverError() << errinfo_comment(string("Could not create socket: ") + strerror(errno)));
+#else
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+		BOOST_THROW_EXCEPTION(SolverError() << errinfo_comment(string("Could not create socket: ") + strerror(errno)));
+	fcntl(sockets[0], F_SETFD, FD_CLOEXEC);
+	fcntl(sockets[1], F_SETFD, FD_CLOEXEC);
+#endif
+#ifdef SO_NOSIGPIPE
+	int noSigPipe = 1;
+	setsockopt(sockets[0], SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, sockets[1], STDIN_FILENO);
+	posix_spawn_file_actions_adddup2(&actions, sockets[1], STDOUT_FILENO);
+	posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+	vector<char*> arguments;
+	for (auto const& argument: _command)
+		arguments.emplace_back(const_cast<char*>(argument.c_str()));
+	arguments.emplace_back(nullptr);
+	pid_t pid;
+	int error = posix_spawnp(&pid, arguments.front(), &actions, nullptr, arguments.data(), environ);
+	posix_spawn_file_actions_destroy(&actions);
+	close(sockets[1]);
+	if (error != 0)
+	{
+		close(sockets[0]);
+		BOOST_THROW_EXCEPTION(SolverError() << errinfo_comment(
+			"Could not start SMT solver \"" + _command.front() + "\": " + strerror(error)
+		));
+	}
+	m_pid = pid;
+	m_socket = sockets[0];
+	// The socket is only used after poll reported that it is ready, but a write can still
+	// block if the data does not fit into the buffer.
+	fcntl(m_socket, F_SETFL, fcntl(m_socket, F_GETFL) | O_NONBLOCK);
+}
+
+SolverProcess::~SolverProcess()
+{
+	close(m_socket);
+	kill(m_pid, SIGKILL);
+	waitpid(m_pid, nullptr, 0);
+}
+
+bool SolverProcess::write(
+	string const& _commands,
+	chrono::steady_clock::time_point _deadline,
+	atomic<bool> const& _interrupted
+)
+{
+#ifdef MSG_NOSIGNAL
+	int flags = MSG_NOSIGNAL;
+#else
+	int flags = 0;
+#endif
+	size_t written = 0;
+	while (written < _commands.size())
+	{
+		if (_interrupted || chrono::steady_clock::now() >= _deadline)
+			return false;
+		// The output of the process is read in the meantime, since the process
+		// might not read further input while its output is not read.
+		pollfd descriptor{m_socket, POLLIN | POLLOUT, 0};
+		if (poll(&descriptor, 1, pollTimeout(_deadline)) <= 0)
+			continue;
+		if (descriptor.revents & POLLIN)
+			receive();
+		if (descriptor.revents & POLLOUT)
+		{
+			ssize_t result = send(m_socket, _commands.data() + written, _commands.size() - written, flags);
+			if (result < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)
+				BOOST_THROW_EXCEPTION(SolverError() << errinfo_comment("The SMT solver does not accept input anymore."));
+			if (result > 0)
+				written += size_t(result);
+		}
+		else if (descriptor.revents & (POLLERR | POLLHUP | POLLNVAL))
+			BOOST_THROW_EXCEPTION(SolverError() << errinfo_comment("The SMT solver does not accept input anymore."));
+	}
+	return true;
+}
+
+boost::optional<string> SolverProcess::read(chrono::steady_clock::time_point _deadline, atomic<bool> const& _interrupted)
+{
+	while (true)
+	{
+		size_t whitespace = m_output.find_first_not_of(" \t\r\n");
+		m_output.erase(0, whitespace == string::npos ? m_output.size() : whitespace);
+		if (size_t length = responseLength())
+		{
+			string response = m_output.substr(0, length);
+			m_output.erase(0, length);
+			return response;
+		}
+
+		if (_interrupted || chrono::steady_clock::now() >= _deadline)
+			return boost::none;
+		pollfd descriptor{m_socket, POLLIN, 0};
+		if (poll(&descriptor, 1, pollTimeout(_deadline)) > 0)
+			receive();
+	}
+}
+
+void SolverProcess::receive()
+{
+	char buffer[4096];
+	ssize_t bytes = ::read(m_socket, buffer, sizeof(buffer));
+	if (bytes < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+		return;
+	if (bytes <= 0)
+		BOOST_THROW_EXCEPTION(SolverError() << errinfo_comment("The SMT solver terminated unexpectedly."));
+	m_output.append(buffer, size_t(bytes));
+}
+
+int SolverProcess::pollTimeout(chrono::steady_clock::time_point _deadline)
+{
+	auto now = chrono::steady_clock::now();
+	if (now >= _deadline)
+		return 0;
+	// Wakes up regularly to check whether the query was interrupted.
+	auto timeout = min<chrono::steady_clock::duration>(_deadline - now, chrono::milliseconds(50));
+	return int(chrono::duration_cast<chrono::milliseconds>(timeout).count()) + 1;
+}
+
+#endif
+
+size_t SolverProcess::responseLength() const
+{
+	if (m_output.empty())
+		return 0;
+	if (m_output.front() != '(')
+	{
+		// A symbol is only complete once it is followed by something else.
+		size_t end = m_output.find_first_of(" \t\r\n()");
+		return end == string::npos ? 0 : end;
+	}
+
+	size_t depth = 0;
+	for (size_t i = 0; i < m_output.size(); ++i)
+		switch (m_output[i])
+		{
+		case '(':
+			++depth;
+			break;
+		case ')':
+			if (--depth == 0)
+				return i + 1;
+			break;
+		case '|':
+		case '"':
+		{
+			// Quoted symbols and strings can contain parentheses. Quotes in strings are
+			// escaped by doubling them, which is handled as two consecutive strings.
+			size_t end = m_output.find(m_output[i], i + 1);
+			if (end == string::npos)
+				return 0;
+			i = end;
+			break;
+		}
+		case ';':
+		{
+			size_t end = m_output.find('\n', i);
+			if (end == string::npos)
+				return 0;
+			i = end;
+			break;
+		}
+		}
+	return 0;
+}
@@ -0,0 +1,91 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Child process that runs an SMT-LIB2 solver.
+ */
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+namespace smt
+{
+
+/**
+ * Runs an SMT-LIB2 solver that reads commands from its standard input and writes
+ * the responses to its standard output, for example `z3 -in` or
+ * `cvc4 --lang smt2 --incremental`.
+ *
+ * Not supported on Windows, where the constructor throws SolverError.
+ */
+class SolverProcess: public boost::noncopyable
+{
+public:
+	/// Starts @a _command, i.e. the executable given by its first element (which is
+	/// searched in PATH if it does not contain a slash) with the remaining elements as arguments.
+	/// Throws SolverError if the process cannot be started.
+	explicit SolverProcess(std::vector<std::string> const& _command);
+	/// Kills the process.
+	~SolverProcess();
+
+	/// Sends @a _commands to the process and reads its output in the meantime.
+	/// @returns false if they could not be sent completely until @a _deadline or until
+	/// @a _interrupted is set, in which case the process should not be used anymore.
+	/// Throws SolverError if the process does not accept input anymore.
+	bool write(
+		std::string const& _commands,
+		std::chrono::steady_clock::time_point _deadline,
+		std::atomic<bool> const& _interrupted
+	);
+	/// @returns the next response of the process, i.e. the next symbol or parenthesized
+	/// expression on its output, or boost::none if there is none until @a _deadline
+	/// or until @a _interrupted is set.
+	/// Throws SolverError if the process terminated.
+	boost::optional<std::string> read(
+		std::chrono::steady_clock::time_point _deadline,
+		std::atomic<bool> const& _interrupted
+	);
+
+private:
+	/// @returns the length of the response at the start of m_output or zero if it is incomplete.
+	size_t responseLength() const;
+	/// Appends the available output of the process to m_output.
+	/// Throws SolverError if the process terminated.
+	void receive();
+	/// @returns the timeout for poll in milliseconds when waiting until @a _deadline.
+	static int pollTimeout(std::chrono::steady_clock::time_point _deadline);
+
+	int m_pid = -1;
+	/// End of the socket connected to the standard input and output of the process.
+	int m_socket = -1;
+	/// Output of the process that was not returned by read yet.
+	std::string m_output;
+};
+
+}
+}
+}
@@ -20,6 +20,8 @@
 #include <liblangutil/Exceptions.h>
 #include <libdevcore/CommonIO.h>
 
+#include <limits>
+
 using namespace std;
 using namespace dev;
 using namespace dev::solidity::smt;
@@ -30,24 +32,29 @@ Z3Interface::Z3Interface():
 	// This needs to be set globally.
 	z3::set_param("rewriter.pull_cheap_ite", true);
 	// This needs to be set in the context.
-	m_context.set("timeout", queryTimeout);
+	m_context.set("timeout", int(m_queryTimeout));
 }
 
 void Z3Interface::reset()
 {
+	m_translatedExpressions.clear();
 	m_constants.clear();
 	m_functions.clear();
+	m_assumptionLiterals = {{}};
 	m_solver.reset();
 }
 
 void Z3Interface::push()
 {
 	m_solver.push();
+	m_assumptionLiterals.emplace_back();
 }
 
 void Z3Interface::pop()
 {
 	m_solver.pop();
+	solAssert(m_assumptionLiterals.size() > 1, "");
+	m_assumptionLiterals.pop_back();
 }
 
 void Z3Interface::declareVariable(string const& _name, Sort const& _sort)
@@ -75,11 +82,22 @@ void Z3Interface::addAssertion(Expression const& _expr)
 
 pair<CheckResult, vector<string>> Z3Interface::check(vector<Expression> const& _expressionsToEvaluate)
 {
-	CheckResult result;
+	return checkAssuming({}, _expressionsToEvaluate);
+}
+
+pair<CheckResult, vector<string>> Z3Interface::checkAssuming(
+	vector<Expression> const& _assumptions,
+	vector<Expression> const& _expressionsToEvaluate
+)
+{
+	CheckResult result = CheckResult::ERROR;
 	vector<string> values;
 	try
 	{
-		switch (m_solver.check())
+		z3::expr_vector literals(m_context);
+		for (Expression const& assumption: _assumptions)
+			literals.push_back(assumptionLiteral(assumption));
+		switch (literals.empty() ? m_solver.check() : m_solver.check(literals))
 		{
 		case z3::check_result::sat:
 			result = CheckResult::SATISFIABLE;
@@ -108,26 +126,70 @@ pair<CheckResult, vector<string>> Z3Interface::check(vector<Expression> const& _
 	return make_pair(result, values);
 }
 
+void Z3Interface::setTimeout(unsigned _milliseconds)
+{
+	SolverInterface::setTimeout(_milliseconds);
+	z3::params params(m_context);
+	params.set("timeout", _milliseconds ? _milliseconds : numeric_limits<unsigned>::max());
+	m_solver.set(params);
+}
+
+void Z3Interface::setMemoryLimit(unsigned _megabytes)
+{
+	z3::params params(m_context);
+	params.set("max_memory", _megabytes ? _megabytes : numeric_limits<unsigned>::max());
+	m_solver.set(params);
+}
+
+void Z3Interface::interrupt()
+{
+	m_context.interrupt();
+}
+
+string Z3Interface::identity() const
+{
+	return string("z3 ") + Z3_get_full_version();
+}
+
+z3::expr Z3Interface::assumptionLiteral(Expression const& _assumption)
+{
+	for (auto const& scope: m_assumptionLiterals)
+	{
+		auto it = scope.find(_assumption);
+		if (it != scope.end())
+			return it->second;
+	}
+	// Checking under the literal is equivalent to checking under the assumption,
+	// but unlike a scope that is popped afterwards, it lets the solver keep the
+	// lemmas it learns for the next queries.
+	z3::expr literal(m_context, Z3_mk_fresh_const(m_context, "assumption", m_context.bool_sort()));
+	m_solver.add(z3::implies(literal, toZ3Expr(_assumption)));
+	m_assumptionLiterals.back().emplace(_assumption, literal);
+	return literal;
+}
+
 z3::expr Z3Interface::toZ3Expr(Expression const& _expr)
 {
-	if (_expr.arguments.empty() && m_constants.count(_expr.name))
-		return m_constants.at(_expr.name);
+	auto it = m_translatedExpressions.find(_expr);
+	if (it != m_translatedExpressions.end())
+		return it->second;
+	z3::expr result = translate(_expr);
+	m_translatedExpressions.emplace(_expr, result);
+	return result;
+}
+
+z3::expr Z3Interface::translate(Expression const& _expr)
+{
 	z3::expr_vector arguments(m_context);
-	for (auto const& arg: _expr.arguments)
+	for (auto const& arg: _expr.arguments())
 		arguments.push_back(toZ3Expr(arg));
 
 	try
 	{
-		string const& n = _expr.name;
-		if (m_functions.count(n))
-			return m_functions.at(n)(arguments);
-		else if (m_constants.count(n))
-		{
-			solAssert(arguments.empty(), "");
-			return m_constants.at(n);
-		}
-		else if (arguments.empty())
+		string const& n = _expr.name();
+		switch (_expr.op())
 		{
+		case Operator::Literal:
 			if (n == "true")
 				return m_context.bool_val(true);
 			else if (n == "false")
@@ -141,43 +203,58 @@ z3::expr Z3Interface::toZ3Expr(Expression const& _expr)
 				{
 					solAssert(false, _e.msg());
 				}
+		case Operator::Variable:
+			if (m_constants.count(n))
+				return m_constants.at(n);
+			solAssert(m_functions.count(n), "Undeclared variable " + n);
+			return m_functions.at(n)(arguments);
+		case Operator::Application:
+			solAssert(m_functions.count(n), "Undeclared function " + n);
+			return m_functions.at(n)(arguments);
+		default:
+			break;
 		}
 
 		solAssert(_expr.hasCorrectArity(), "");
-		if (n == "ite")
+		switch (_expr.op())
+		{
+		case Operator::Ite:
 			return z3::ite(arguments[0], arguments[1], arguments[2]);
-		else if (n == "not")
+		case Operator::Not:
 			return !arguments[0];
-		else if (n == "and")
+		case Operator::And:
 			return arguments[0] && arguments[1];
-		else if (n == "or")
+		case Operator::Or:
 			return arguments[0] || arguments[1];
-		else if (n == "implies")
+		case Operator::Implies:
 			return z3::implies(arguments[0], arguments[1]);
-		else if (n == "=")
+		case Operator::Equal:
 			return arguments[0] == arguments[1];
-		else if (n == "<")
+		case Operator::Less:
 			return arguments[0] < arguments[1];
-		else if (n == "<=")
+		case Operator::LessOrEqual:
 			return arguments[0] <= arguments[1];
-		else if (n == ">")
+		case Operator::Greater:
 			return arguments[0] > arguments[1];
-		else if (n == ">=")
+		case Operator::GreaterOrEqual:
 			return arguments[0] >= arguments[1];
-		else if (n == "+")
+		case Operator::Add:
 			return arguments[0] + arguments[1];
-		else if (n == "-")
+		case Operator::Sub:
 			return arguments[0] - arguments[1];
-		else if (n == "*")
+		case Operator::Mul:
 			return arguments[0] * arguments[1];
-		else if (n == "/")
+		case Operator::Div:
 			return arguments[0] / arguments[1];
-		else if (n == "mod")
+		case Operator::Mod:
 			return z3::mod(arguments[0], arguments[1]);
-		else if (n == "select")
+		case Operator::Select:
 			return z3::select(arguments[0], arguments[1]);
-		else if (n == "store")
+		case Operator::Store:
 			return z3::store(arguments[0], arguments[1], arguments[2]);
+		default:
+			break;
+		}
 
 		solAssert(false, "");
 	}
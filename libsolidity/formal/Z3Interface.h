@@ -42,18 +42,36 @@ public:
 
 	void addAssertion(Expression const& _expr) override;
 	std::pair<CheckResult, std::vector<std::string>> check(std::vector<Expression> const& _expressionsToEvaluate) override;
+	std::pair<CheckResult, std::vector<std::string>> checkAssuming(
+		std::vector<Expression> const& _assumptions,
+		std::vector<Expression> const& _expressionsToEvaluate
+	) override;
+	void interrupt() override;
+
+	std::string identity() const override;
+
+	void setTimeout(unsigned _milliseconds) override;
+	void setMemoryLimit(unsigned _megabytes) override;
 
 private:
 	void declareFunction(std::string const& _name, Sort const& _sort);
 
+	/// @returns the translation of @a _expr, which is only computed once per expression.
 	z3::expr toZ3Expr(Expression const& _expr);
+	z3::expr translate(Expression const& _expr);
 	z3::sort z3Sort(smt::Sort const& _sort);
 	z3::sort_vector z3Sort(std::vector<smt::SortPointer> const& _sorts);
+	/// @returns a fresh Boolean constant that implies @a _assumption in the current scope,
+	/// which is only created once per assumption and scope.
+	z3::expr assumptionLiteral(Expression const& _assumption);
 
 	z3::context m_context;
 	z3::solver m_solver;
 	std::map<std::string, z3::expr> m_constants;
 	std::map<std::string, z3::func_decl> m_functions;
+	ExpressionMap<z3::expr> m_translatedExpressions;
+	/// Literals of the assumptions per scope opened by push, the first element is the outermost scope.
+	std::vector<ExpressionMap<z3::expr>> m_assumptionLiterals{{}};
 };
 
 }
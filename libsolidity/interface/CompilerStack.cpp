@@ -63,6 +63,7 @@
 
 #include <libdevcore/SwarmHash.h>
 #include <libdevcore/IpfsHash.h>
+#include <libdevcore/Keccak256.h>
 #include <libdevcore/JSON.h>
 
 #include <json/json.h>
@@ -131,6 +132,13 @@ void CompilerStack::setEVMVersion(langutil::EVMVersion _version)
 	m_evmVersion = _version;
 }
 
+void CompilerStack::setModelCheckerSettings(ModelCheckerSettings _settings)
+{
+	if (m_stackState >= ParsingSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Must set model checker settings before parsing."));
+	m_modelCheckerSettings = std::move(_settings);
+}
+
 void CompilerStack::setLibraries(std::map<std::string, h160> const& _libraries)
 {
 	if (m_stackState >= ParsingSuccessful)
@@ -172,11 +180,13 @@ void CompilerStack::reset(bool _keepSettings)
 	m_sources.clear();
 	m_smtlib2Responses.clear();
 	m_unhandledSMTLib2Queries.clear();
+	m_modelCheckerReport.clear();
 	if (!_keepSettings)
 	{
 		m_remappings.clear();
 		m_libraries.clear();
 		m_evmVersion = langutil::EVMVersion();
+		m_modelCheckerSettings = ModelCheckerSettings{};
 		m_generateIR = false;
 		m_generateEWasm = false;
 		m_optimiserSettings = OptimiserSettings::minimal();
@@ -371,10 +381,11 @@ bool CompilerStack::analyze()
 
 		if (noErrors)
 		{
-			ModelChecker modelChecker(m_errorReporter, m_smtlib2Responses);
+			ModelChecker modelChecker(m_errorReporter, m_smtlib2Responses, m_modelCheckerSettings);
 			for (Source const* source: m_sourceOrder)
 				modelChecker.analyze(*source->ast, source->scanner);
 			m_unhandledSMTLib2Queries += modelChecker.unhandledQueries();
+			m_modelCheckerReport = modelChecker.report();
 		}
 	}
 	catch(FatalError const&)
@@ -1089,6 +1100,20 @@ string CompilerStack::createMetadata(Contract const& _contract) const
 	for (auto const sourceUnit: _contract.contract->sourceUnit().referencedSourceUnits(true))
 		referencedSources.insert(sourceUnit->annotation().path);
 
+	// Hash all sources that have not been hashed before at once.
+	vector<Source const*> unhashedSources;
+	vector<bytesConstRef> unhashedContents;
+	for (auto const& s: m_sources)
+		if (referencedSources.count(s.first) && s.second.keccak256HashCached == h256{})
+		{
+			solAssert(s.second.scanner, "Scanner not available");
+			unhashedSources.push_back(&s.second);
+			unhashedContents.push_back(bytesConstRef(s.second.scanner->source()));
+		}
+	vector<h256> hashes = dev::keccak256Batch(unhashedContents);
+	for (size_t i = 0; i < unhashedSources.size(); ++i)
+		unhashedSources[i]->keccak256HashCached = hashes[i];
+
 	meta["sources"] = Json::objectValue;
 	for (auto const& s: m_sources)
 	{
@@ -1264,75 +1289,7 @@ string CompilerStack::computeSourceMapping(eth::AssemblyItems const& _items) con
 	if (m_stackState != CompilationSuccessful)
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
 
-	string ret;
-	map<string, unsigned> sourceIndicesMap = sourceIndices();
-	int prevStart = -1;
-	int prevLength = -1;
-	int prevSourceIndex = -1;
-	char prevJump = 0;
-	for (auto const& item: _items)
-	{
-		if (!ret.empty())
-			ret += ";";
-
-		SourceLocation const& location = item.location();
-		int length = location.start != -1 && location.end != -1 ? location.end - location.start : -1;
-		int sourceIndex =
-			location.source && sourceIndicesMap.count(location.source->name()) ?
-			sourceIndicesMap.at(location.source->name()) :
-			-1;
-		char jump = '-';
-		if (item.getJumpType() == eth::AssemblyItem::JumpType::IntoFunction)
-			jump = 'i';
-		else if (item.getJumpType() == eth::AssemblyItem::JumpType::OutOfFunction)
-			jump = 'o';
-
-		unsigned components = 4;
-		if (jump == prevJump)
-		{
-			components--;
-			if (sourceIndex == prevSourceIndex)
-			{
-				components--;
-				if (length == prevLength)
-				{
-					components--;
-					if (location.start == prevStart)
-						components--;
-				}
-			}
-		}
-
-		if (components-- > 0)
-		{
-			if (location.start != prevStart)
-				ret += to_string(location.start);
-			if (components-- > 0)
-			{
-				ret += ':';
-				if (length != prevLength)
-					ret += to_string(length);
-				if (components-- > 0)
-				{
-					ret += ':';
-					if (sourceIndex != prevSourceIndex)
-						ret += to_string(sourceIndex);
-					if (components-- > 0)
-					{
-						ret += ':';
-						if (jump != prevJump)
-							ret += jump;
-					}
-				}
-			}
-		}
-
-		prevStart = location.start;
-		prevLength = length;
-		prevSourceIndex = sourceIndex;
-		prevJump = jump;
-	}
-	return ret;
+	return eth::computeSourceMapping(_items, sourceIndices());
 }
 
 namespace
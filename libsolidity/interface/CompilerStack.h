@@ -23,6 +23,8 @@
 
 #pragma once
 
+#include <libsolidity/formal/ModelCheckerReport.h>
+#include <libsolidity/formal/ModelCheckerSettings.h>
 #include <libsolidity/interface/ReadFile.h>
 #include <libsolidity/interface/OptimiserSettings.h>
 #include <libsolidity/interface/Version.h>
@@ -146,6 +148,10 @@ public:
 	/// Must be set before parsing.
 	void setEVMVersion(langutil::EVMVersion _version = langutil::EVMVersion{});
 
+	/// Sets the settings of the model checker (SMTChecker).
+	/// Must be set before parsing.
+	void setModelCheckerSettings(ModelCheckerSettings _settings);
+
 	/// Sets the requested contract names by source.
 	/// If empty, no filtering is performed and every contract
 	/// found in the supplied sources is compiled.
@@ -211,6 +217,9 @@ public:
 	/// by calling @a addSMTLib2Response).
 	std::vector<std::string> const& unhandledSMTLib2Queries() const { return m_unhandledSMTLib2Queries; }
 
+	/// @returns the verification targets checked by the model checker.
+	ModelCheckerReport const& modelCheckerReport() const { return m_modelCheckerReport; }
+
 	/// @returns a list of the contract names in the sources.
 	std::vector<std::string> contractNames() const;
 
@@ -394,6 +403,7 @@ private:
 	ReadCallback::Callback m_readFile;
 	OptimiserSettings m_optimiserSettings;
 	langutil::EVMVersion m_evmVersion;
+	ModelCheckerSettings m_modelCheckerSettings;
 	std::map<std::string, std::set<std::string>> m_requestedContractNames;
 	bool m_generateIR;
 	bool m_generateEWasm;
@@ -403,6 +413,7 @@ private:
 	std::vector<Remapping> m_remappings;
 	std::map<std::string const, Source> m_sources;
 	std::vector<std::string> m_unhandledSMTLib2Queries;
+	ModelCheckerReport m_modelCheckerReport;
 	std::map<h256, std::string> m_smtlib2Responses;
 	std::shared_ptr<GlobalContext> m_globalContext;
 	std::vector<Source const*> m_sourceOrder;
@@ -33,6 +33,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/optional.hpp>
 #include <algorithm>
+#include <functional>
 
 using namespace std;
 using namespace dev;
@@ -278,12 +279,22 @@ Json::Value formatLinkReferences(std::map<size_t, std::string> const& linkRefere
 	return ret;
 }
 
-Json::Value collectEVMObject(eth::LinkerObject const& _object, string const* _sourceMap)
+/// @param _sourceMap returns the source map, only called if @a _includeSourceMap is true,
+/// since computing the source map is expensive for large contracts.
+Json::Value collectEVMObject(
+	eth::LinkerObject const& _object,
+	bool _includeSourceMap,
+	function<string const*()> const& _sourceMap
+)
 {
 	Json::Value output = Json::objectValue;
 	output["object"] = _object.toHex();
 	output["opcodes"] = dev::eth::disassemble(_object.bytecode);
-	output["sourceMap"] = _sourceMap ? *_sourceMap : "";
+	if (_includeSourceMap)
+	{
+		string const* sourceMap = _sourceMap ? _sourceMap() : nullptr;
+		output["sourceMap"] = sourceMap ? *sourceMap : "";
+	}
 	output["linkReferences"] = formatLinkReferences(_object.linkReferences);
 	return output;
 }
@@ -320,7 +331,7 @@ boost::optional<Json::Value> checkAuxiliaryInputKeys(Json::Value const& _input)
 
 boost::optional<Json::Value> checkSettingsKeys(Json::Value const& _input)
 {
-	static set<string> keys{"parserErrorRecovery", "evmVersion", "libraries", "metadata", "optimizer", "outputSelection", "remappings"};
+	static set<string> keys{"parserErrorRecovery", "evmVersion", "libraries", "metadata", "modelChecker", "optimizer", "outputSelection", "remappings"};
 	return checkKeys(_input, keys, "settings");
 }
 
@@ -355,6 +366,14 @@ boost::optional<Json::Value> checkMetadataKeys(Json::Value const& _input)
 	return checkKeys(_input, keys, "settings.metadata");
 }
 
+boost::optional<Json::Value> checkModelCheckerKeys(Json::Value const& _input)
+{
+	if (_input.isObject() && _input.isMember("workers") && !_input["workers"].isUInt())
+		return formatFatalError("JSONError", "\"settings.modelChecker.workers\" must be an unsigned number");
+	static set<string> keys{"workers"};
+	return checkKeys(_input, keys, "settings.modelChecker");
+}
+
 boost::optional<Json::Value> checkOutputSelection(Json::Value const& _outputSelection)
 {
 	if (!!_outputSelection && !_outputSelection.isObject())
@@ -682,6 +701,13 @@ boost::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompile
 
 	ret.metadataLiteralSources = metadataSettings.get("useLiteralContent", Json::Value(false)).asBool();
 
+	Json::Value modelCheckerSettings = settings.get("modelChecker", Json::Value());
+
+	if (auto result = checkModelCheckerKeys(modelCheckerSettings))
+		return *result;
+
+	ret.modelCheckerSettings.workers = max(1u, modelCheckerSettings.get("workers", Json::Value(1u)).asUInt());
+
 	Json::Value outputSelection = settings.get("outputSelection", Json::Value());
 
 	if (auto jsonError = checkOutputSelection(outputSelection))
@@ -706,6 +732,7 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 	compilerStack.setOptimiserSettings(std::move(_inputsAndSettings.optimiserSettings));
 	compilerStack.setLibraries(_inputsAndSettings.libraries);
 	compilerStack.useMetadataLiteralSources(_inputsAndSettings.metadataLiteralSources);
+	compilerStack.setModelCheckerSettings(_inputsAndSettings.modelCheckerSettings);
 	compilerStack.setRequestedContractNames(requestedContractNames(_inputsAndSettings.outputSelection));
 
 	compilerStack.enableIRGeneration(isIRRequested(_inputsAndSettings.outputSelection));
@@ -895,7 +922,14 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 		))
 			evmData["bytecode"] = collectEVMObject(
 				compilerStack.object(contractName),
-				compilerStack.sourceMapping(contractName)
+				isArtifactRequested(
+					_inputsAndSettings.outputSelection,
+					file,
+					name,
+					vector<string>{ "evm.bytecode", "evm.bytecode.sourceMap" },
+					wildcardMatchesExperimental
+				),
+				[&]() { return compilerStack.sourceMapping(contractName); }
 			);
 
 		if (compilationSuccess && isArtifactRequested(
@@ -907,7 +941,14 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 		))
 			evmData["deployedBytecode"] = collectEVMObject(
 				compilerStack.runtimeObject(contractName),
-				compilerStack.runtimeSourceMapping(contractName)
+				isArtifactRequested(
+					_inputsAndSettings.outputSelection,
+					file,
+					name,
+					vector<string>{ "evm.deployedBytecode", "evm.deployedBytecode.sourceMap" },
+					wildcardMatchesExperimental
+				),
+				[&]() { return compilerStack.runtimeSourceMapping(contractName); }
 			);
 
 		if (!evmData.empty())
@@ -992,7 +1033,17 @@ Json::Value StandardCompiler::compileYul(InputsAndSettings _inputsAndSettings)
 		{ "evm.bytecode", "evm.bytecode.object", "evm.bytecode.opcodes", "evm.bytecode.sourceMap", "evm.bytecode.linkReferences" },
 		wildcardMatchesExperimental
 	))
-		output["contracts"][sourceName][contractName]["evm"]["bytecode"] = collectEVMObject(*object.bytecode, nullptr);
+		output["contracts"][sourceName][contractName]["evm"]["bytecode"] = collectEVMObject(
+			*object.bytecode,
+			isArtifactRequested(
+				_inputsAndSettings.outputSelection,
+				sourceName,
+				contractName,
+				vector<string>{ "evm.bytecode", "evm.bytecode.sourceMap" },
+				wildcardMatchesExperimental
+			),
+			{}
+		);
 
 	if (isArtifactRequested(_inputsAndSettings.outputSelection, sourceName, contractName, "irOptimized", wildcardMatchesExperimental))
 		output["contracts"][sourceName][contractName]["irOptimized"] = stack.print();
@@ -171,14 +171,44 @@ void CodeTransform::deleteVariable(Scope::Variable const& _var)
 	m_variablesScheduledForDeletion.erase(&_var);
 }
 
+bool CodeTransform::consumeVariable(Identifier const& _identifier)
+{
+	if (!m_allowStackOpt || m_inForLoopCondition)
+		return false;
+
+	// Only variables of the current scope are considered, since references
+	// in nested scopes might be executed multiple times (inside loops) and
+	// function parameters have to remain in place until the end of the function.
+	auto identifier = m_scope->identifiers.find(_identifier.name);
+	if (identifier == m_scope->identifiers.end() || identifier->second.type() != typeid(Scope::Variable))
+		return false;
+	Scope::Variable const& var = boost::get<Scope::Variable>(identifier->second);
+	if (
+		!m_context->variableReferences.count(&var) ||
+		m_context->variableReferences.at(&var) != 1 ||
+		!m_context->variableStackHeights.count(&var) ||
+		m_context->variableStackHeights.at(&var) != m_assembly.stackHeight() - 1
+	)
+		return false;
+
+	// The variable is removed without popping it, the value on top of the stack
+	// now belongs to the expression.
+	m_context->variableStackHeights.erase(&var);
+	m_context->variableReferences.erase(&var);
+	m_variablesScheduledForDeletion.erase(&var);
+	--m_stackAdjustment;
+	checkStackHeight(&_identifier);
+	return true;
+}
+
 void CodeTransform::operator()(VariableDeclaration const& _varDecl)
 {
 	solAssert(m_scope, "");
 
 	int const numVariables = _varDecl.variables.size();
-	int height = m_assembly.stackHeight();
 	if (_varDecl.value)
 	{
+		int height = m_assembly.stackHeight() - m_stackAdjustment;
 		boost::apply_visitor(*this, *_varDecl.value);
 		expectDeposit(numVariables, height);
 	}
@@ -188,6 +218,8 @@ void CodeTransform::operator()(VariableDeclaration const& _varDecl)
 		while (variablesLeft--)
 			m_assembly.appendConstant(u256(0));
 	}
+	// The value might occupy stack slots of consumed variables.
+	int const height = m_assembly.stackHeight() - numVariables;
 
 	bool atTopOfStack = true;
 	for (int varIndex = numVariables - 1; varIndex >= 0; --varIndex)
@@ -241,7 +273,7 @@ void CodeTransform::stackError(StackTooDeepError _error, int _targetStackHeight)
 
 void CodeTransform::operator()(Assignment const& _assignment)
 {
-	int height = m_assembly.stackHeight();
+	int height = m_assembly.stackHeight() - m_stackAdjustment;
 	boost::apply_visitor(*this, *_assignment.value);
 	expectDeposit(_assignment.variableNames.size(), height);
 
@@ -364,8 +396,8 @@ void CodeTransform::operator()(Identifier const& _identifier)
 	if (m_scope->lookup(_identifier.name, Scope::NonconstVisitor(
 		[=](Scope::Variable& _var)
 		{
-			// TODO: opportunity for optimization: Do not DUP if this is the last reference
-			// to the top most element of the stack
+			// Note that the last reference to the top most element of the stack
+			// is handled by consumeVariable in visitExpression.
 			if (int heightDiff = variableHeightDiff(_var, _identifier.name, false))
 				m_assembly.appendInstruction(dev::eth::dupInstruction(heightDiff));
 			else
@@ -608,7 +640,9 @@ void CodeTransform::operator()(ForLoop const& _forLoop)
 	m_assembly.setSourceLocation(_forLoop.location);
 	m_assembly.appendLabel(loopStart);
 
+	m_inForLoopCondition = true;
 	visitExpression(*_forLoop.condition);
+	m_inForLoopCondition = false;
 	m_assembly.setSourceLocation(_forLoop.location);
 	m_assembly.appendInstruction(dev::eth::Instruction::ISZERO);
 	m_assembly.appendJumpToIf(loopEnd);
@@ -716,7 +750,9 @@ AbstractAssembly::LabelID CodeTransform::functionEntryID(YulString _name, Scope:
 
 void CodeTransform::visitExpression(Expression const& _expression)
 {
-	int height = m_assembly.stackHeight();
+	if (_expression.type() == typeid(Identifier) && consumeVariable(boost::get<Identifier>(_expression)))
+		return;
+	int height = m_assembly.stackHeight() - m_stackAdjustment;
 	boost::apply_visitor(*this, _expression);
 	expectDeposit(1, height);
 }
@@ -830,7 +866,7 @@ int CodeTransform::variableHeightDiff(Scope::Variable const& _var, YulString _va
 
 void CodeTransform::expectDeposit(int _deposit, int _oldHeight) const
 {
-	solAssert(m_assembly.stackHeight() == _oldHeight + _deposit, "Invalid stack deposit.");
+	solAssert(m_assembly.stackHeight() - m_stackAdjustment == _oldHeight + _deposit, "Invalid stack deposit.");
 }
 
 void CodeTransform::checkStackHeight(void const* _astElement) const
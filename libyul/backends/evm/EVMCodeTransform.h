@@ -169,6 +169,11 @@ protected:
 	void freeUnusedVariables();
 	/// Marks the stack slot of @a _var to be reused.
 	void deleteVariable(Scope::Variable const& _var);
+	/// If @a _identifier is the last reference to a variable of the current scope that
+	/// is on top of the stack, takes over its stack slot as the value of the expression
+	/// instead of duplicating it and removing the variable later.
+	/// @returns true if the variable was consumed.
+	bool consumeVariable(Identifier const& _identifier);
 
 public:
 	void operator()(Instruction const& _instruction);
@@ -212,6 +217,9 @@ private:
 	/// the (positive) stack height difference otherwise.
 	int variableHeightDiff(Scope::Variable const& _var, YulString _name, bool _forSwap);
 
+	/// Asserts that the stack grew by @a _deposit elements since it had the height @a _oldHeight.
+	/// Both heights are taken relative to the stack adjustment, since the stack slots of
+	/// consumed variables are re-used for the value of the expression.
 	void expectDeposit(int _deposit, int _oldHeight) const;
 
 	void checkStackHeight(void const* _astElement) const;
@@ -245,6 +253,9 @@ private:
 	/// statement level in the scope where the variable was defined.
 	std::set<Scope::Variable const*> m_variablesScheduledForDeletion;
 	std::set<int> m_unusedStackSlots;
+	/// True while generating code for the condition of a for loop, which is evaluated
+	/// multiple times, so variables cannot be consumed.
+	bool m_inForLoopCondition = false;
 
 	std::vector<StackTooDeepError> m_stackErrors;
 };
@@ -45,6 +45,11 @@ size_t GasMeter::instructionCosts(eth::Instruction _instruction) const
 	return combineCosts(GasMeterVisitor::instructionCosts(_instruction, m_dialect, m_isCreation));
 }
 
+size_t GasMeter::codeSizeCosts(size_t _bytes) const
+{
+	return combineCosts({0, _bytes * GasMeterVisitor::singleByteDataGas(m_isCreation)});
+}
+
 size_t GasMeter::combineCosts(std::pair<size_t, size_t> _costs) const
 {
 	return _costs.first * m_runs + _costs.second;
@@ -95,19 +100,19 @@ void GasMeterVisitor::operator()(Literal const& _lit)
 {
 	m_runGas += dev::eth::GasMeter::runGas(dev::eth::Instruction::PUSH1);
 	m_dataGas +=
-		singleByteDataGas() +
+		singleByteDataGas(m_isCreation) +
 		size_t(dev::eth::GasMeter::dataGas(dev::toCompactBigEndian(valueOfLiteral(_lit), 1), m_isCreation));
 }
 
 void GasMeterVisitor::operator()(Identifier const&)
 {
 	m_runGas += dev::eth::GasMeter::runGas(dev::eth::Instruction::DUP1);
-	m_dataGas += singleByteDataGas();
+	m_dataGas += singleByteDataGas(m_isCreation);
 }
 
-size_t GasMeterVisitor::singleByteDataGas() const
+size_t GasMeterVisitor::singleByteDataGas(bool _isCreation)
 {
-	if (m_isCreation)
+	if (_isCreation)
 		return dev::eth::GasCosts::txDataNonZeroGas;
 	else
 		return dev::eth::GasCosts::createDataGas;
@@ -119,5 +124,5 @@ void GasMeterVisitor::instructionCostsInternal(dev::eth::Instruction _instructio
 		m_runGas += dev::eth::GasCosts::expGas + dev::eth::GasCosts::expByteGas(m_dialect.evmVersion());
 	else
 		m_runGas += dev::eth::GasMeter::runGas(_instruction);
-	m_dataGas += singleByteDataGas();
+	m_dataGas += singleByteDataGas(m_isCreation);
 }
@@ -50,6 +50,10 @@ public:
 	/// @returns the combined costs of deploying and running the instruction, not including
 	/// the costs for its arguments.
 	size_t instructionCosts(dev::eth::Instruction _instruction) const;
+	/// @returns the costs of deploying @a _bytes additional bytes of code.
+	size_t codeSizeCosts(size_t _bytes) const;
+
+	size_t expectedExecutionsPerDeployment() const { return m_runs; }
 
 private:
 	size_t combineCosts(std::pair<size_t, size_t> _costs) const;
@@ -74,6 +78,9 @@ public:
 		bool _isCreation = false
 	);
 
+	/// @returns the costs of deploying a single byte of code.
+	static size_t singleByteDataGas(bool _isCreation);
+
 public:
 	GasMeterVisitor(EVMDialect const& _dialect, bool _isCreation):
 		m_dialect(_dialect),
@@ -86,7 +93,6 @@ public:
 	void operator()(Identifier const& _identifier) override;
 
 private:
-	size_t singleByteDataGas() const;
 	/// Computes the cost of storing and executing the single instruction (excluding its arguments).
 	/// For EXP, it assumes that the exponent is at most 255.
 	/// Does not work particularly exact for anything apart from arithmetic.
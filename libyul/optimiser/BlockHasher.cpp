@@ -15,7 +15,7 @@
 	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
 */
 /**
- * Optimiser component that calculates hash values for block prefixes.
+ * Optimiser components that calculate hash values for blocks and expressions.
  */
 
 #include <libyul/optimiser/BlockHasher.h>
@@ -31,7 +31,7 @@ namespace
 {
 static constexpr uint64_t compileTimeLiteralHash(char const* _literal, size_t _N)
 {
-	return (_N == 0) ? BlockHasher::fnvEmptyHash : (static_cast<uint64_t>(_literal[0]) * BlockHasher::fnvPrime) ^ compileTimeLiteralHash(_literal + 1, _N - 1);
+	return (_N == 0) ? ASTHasherBase::fnvEmptyHash : (static_cast<uint64_t>(_literal[0]) * ASTHasherBase::fnvPrime) ^ compileTimeLiteralHash(_literal + 1, _N - 1);
 }
 
 template<size_t N>
@@ -193,3 +193,45 @@ void BlockHasher::operator()(Block const& _block)
 	for (auto& externalReference: subBlockHasher.m_externalReferences)
 		(*this)(Identifier{{}, externalReference});
 }
+
+uint64_t ExpressionHasher::run(Expression const& _expression)
+{
+	ExpressionHasher hasher;
+	hasher.visit(_expression);
+	return hasher.m_hash;
+}
+
+void ExpressionHasher::operator()(Literal const& _literal)
+{
+	hash64(compileTimeLiteralHash("Literal"));
+	// Number literals are compared by value, so hash the value and not its representation.
+	if (_literal.kind == LiteralKind::Number)
+		for (uint8_t byte: toCompactBigEndian(valueOfNumberLiteral(_literal)))
+			hash8(byte);
+	else
+		hash64(_literal.value.hash());
+	hash64(_literal.type.hash());
+	hash8(static_cast<uint8_t>(_literal.kind));
+}
+
+void ExpressionHasher::operator()(Identifier const& _identifier)
+{
+	hash64(compileTimeLiteralHash("Identifier"));
+	hash64(_identifier.name.hash());
+}
+
+void ExpressionHasher::operator()(FunctionalInstruction const& _instr)
+{
+	hash64(compileTimeLiteralHash("FunctionalInstruction"));
+	hash8(static_cast<std::underlying_type_t<eth::Instruction>>(_instr.instruction));
+	hash64(_instr.arguments.size());
+	ASTWalker::operator()(_instr);
+}
+
+void ExpressionHasher::operator()(FunctionCall const& _funCall)
+{
+	hash64(compileTimeLiteralHash("FunctionCall"));
+	hash64(_funCall.functionName.name.hash());
+	hash64(_funCall.arguments.size());
+	ASTWalker::operator()(_funCall);
+}
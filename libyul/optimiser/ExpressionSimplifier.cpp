@@ -20,6 +20,7 @@
 
 #include <libyul/optimiser/ExpressionSimplifier.h>
 
+#include <libyul/optimiser/KnownBits.h>
 #include <libyul/optimiser/SimplificationRules.h>
 #include <libyul/optimiser/Semantics.h>
 #include <libyul/optimiser/SSAValueTracker.h>
@@ -34,18 +35,25 @@ using namespace yul;
 void ExpressionSimplifier::visit(Expression& _expression)
 {
 	ASTModifier::visit(_expression);
-	while (auto match = SimplificationRules::findFirstMatch(_expression, m_dialect, m_value))
+	while (true)
 	{
-		// Do not apply the rule if it removes non-constant parts of the expression.
-		// TODO: The check could actually be less strict than "movable".
-		// We only require "Does not cause side-effects".
-		// Note: References to variables that are only assigned once are always movable,
-		// so if the value of the variable is not movable, the expression that references
-		// the variable still is.
-
-		if (match->removesNonConstants && !SideEffectsCollector(m_dialect, _expression).movable())
-			return;
-		_expression = match->action().toExpression(locationOf(_expression));
+		if (auto match = SimplificationRules::findFirstMatch(_expression, m_dialect, m_value))
+		{
+			// Do not apply the rule if it removes non-constant parts of the expression.
+			// TODO: The check could actually be less strict than "movable".
+			// We only require "Does not cause side-effects".
+			// Note: References to variables that are only assigned once are always movable,
+			// so if the value of the variable is not movable, the expression that references
+			// the variable still is.
+
+			if (match->removesNonConstants && !SideEffectsCollector(m_dialect, _expression).movable())
+				return;
+			_expression = match->action().toExpression(locationOf(_expression));
+		}
+		else if (auto simplified = KnownBitsAnalyzer{m_dialect, m_value}.simplify(_expression))
+			_expression = std::move(*simplified);
+		else
+			break;
 	}
 }
 
@@ -34,7 +34,9 @@ struct Dialect;
  * this is not required for correctness.
  *
  * It tracks the current values of variables using the DataFlowAnalyzer
- * and takes them into account for replacements.
+ * and takes them into account for replacements. If no rule matches,
+ * it uses the known bits of the values (see KnownBitsAnalyzer) to remove
+ * redundant masks and sign extensions and to evaluate comparisons.
  *
  * Prerequisite: Disambiguator, ForLoopInitRewriter.
  */
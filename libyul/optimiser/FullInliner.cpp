@@ -26,6 +26,7 @@
 #include <libyul/optimiser/OptimizerUtilities.h>
 #include <libyul/optimiser/Metrics.h>
 #include <libyul/optimiser/SSAValueTracker.h>
+#include <libyul/backends/evm/EVMMetrics.h>
 #include <libyul/Exceptions.h>
 #include <libyul/AsmData.h>
 
@@ -38,8 +39,8 @@ using namespace std;
 using namespace dev;
 using namespace yul;
 
-FullInliner::FullInliner(Block& _ast, NameDispenser& _dispenser):
-	m_ast(_ast), m_nameDispenser(_dispenser)
+FullInliner::FullInliner(Block& _ast, NameDispenser& _dispenser, GasMeter const* _meter):
+	m_ast(_ast), m_nameDispenser(_dispenser), m_meter(_meter)
 {
 	// Determine constants
 	SSAValueTracker tracker;
@@ -62,21 +63,21 @@ FullInliner::FullInliner(Block& _ast, NameDispenser& _dispenser):
 			m_singleUse.emplace(fun.name);
 		updateCodeSize(fun);
 	}
+	determineComponents();
 }
 
 void FullInliner::run()
 {
+	for (YulString name: m_functionOrder)
+	{
+		FunctionDefinition& fun = *m_functions.at(name);
+		handleBlock(fun.name, fun.body);
+		updateCodeSize(fun);
+	}
+
 	for (auto& statement: m_ast.statements)
 		if (statement.type() == typeid(Block))
 			handleBlock({}, boost::get<Block>(statement));
-
-	// TODO it might be good to determine a visiting order:
-	// first handle functions that are called from many places.
-	for (auto const& fun: m_functions)
-	{
-		handleBlock(fun.second->name, fun.second->body);
-		updateCodeSize(*fun.second);
-	}
 }
 
 bool FullInliner::shallInline(FunctionCall const& _funCall, YulString _callSite)
@@ -92,6 +93,10 @@ bool FullInliner::shallInline(FunctionCall const& _funCall, YulString _callSite)
 	if (recursive(*calledFunction))
 		return false;
 
+	// Do not inline inside a cycle of the call graph.
+	if (m_component.count(_callSite) && m_component.at(_callSite) == m_component.at(calledFunction->name))
+		return false;
+
 	// Inline really, really tiny functions
 	size_t size = m_functionSizes.at(calledFunction->name);
 	if (size <= 1)
@@ -116,7 +121,11 @@ bool FullInliner::shallInline(FunctionCall const& _funCall, YulString _callSite)
 			break;
 		}
 
-	return (size < 6 || (constantArg && size < 12));
+	if (size < 6 || (constantArg && size < 12))
+		return true;
+
+	// Larger functions are only inlined if the gas meter considers it worth it.
+	return m_meter && inliningPays(*calledFunction, constantArg);
 }
 
 void FullInliner::tentativelyUpdateCodeSize(YulString _function, YulString _callSite)
@@ -124,6 +133,82 @@ void FullInliner::tentativelyUpdateCodeSize(YulString _function, YulString _call
 	m_functionSizes.at(_callSite) += m_functionSizes.at(_function);
 }
 
+void FullInliner::determineComponents()
+{
+	map<YulString, set<YulString>> callees;
+	for (auto const& fun: m_functions)
+		for (auto const& reference: ReferencesCounter::countReferences(fun.second->body))
+			if (m_functions.count(reference.first))
+				callees[fun.first].insert(reference.first);
+
+	// Tarjan's algorithm, which finishes the components of the callees
+	// before the components of their callers.
+	size_t nextIndex = 0;
+	size_t nextComponent = 0;
+	map<YulString, size_t> index;
+	map<YulString, size_t> lowLink;
+	vector<YulString> stack;
+	set<YulString> onStack;
+	std::function<void(YulString)> strongConnect = [&](YulString _name)
+	{
+		index[_name] = lowLink[_name] = nextIndex++;
+		stack.push_back(_name);
+		onStack.insert(_name);
+		for (YulString callee: callees[_name])
+			if (!index.count(callee))
+			{
+				strongConnect(callee);
+				lowLink[_name] = min(lowLink[_name], lowLink[callee]);
+			}
+			else if (onStack.count(callee))
+				lowLink[_name] = min(lowLink[_name], index[callee]);
+
+		if (lowLink[_name] == index[_name])
+		{
+			YulString member;
+			do
+			{
+				member = stack.back();
+				stack.pop_back();
+				onStack.erase(member);
+				m_component[member] = nextComponent;
+				m_functionOrder.push_back(member);
+			}
+			while (member != _name);
+			++nextComponent;
+		}
+	};
+	for (auto const& fun: m_functions)
+		if (!index.count(fun.first))
+			strongConnect(fun.first);
+}
+
+bool FullInliner::inliningPays(FunctionDefinition const& _function, bool _constantArguments) const
+{
+	using dev::eth::Instruction;
+	yulAssert(m_meter, "");
+
+	// Inlining saves pushing the return label and the function label and jumping there
+	// and back. The arguments and return values still have to be moved into the
+	// variables of the inlined body, so the stack shuffling is not saved.
+	size_t callCosts =
+		2 * m_meter->instructionCosts(Instruction::PUSH1) +
+		2 * m_meter->instructionCosts(Instruction::JUMP) +
+		m_meter->instructionCosts(Instruction::JUMPDEST);
+
+	// On the other hand, the body is duplicated, which is only paid for at deployment.
+	// The code size does not count identifiers, which need DUP and SWAP instructions,
+	// and the variables of the inlined body cause additional stack shuffling in the caller.
+	// Six bytes per unit of code size keep the inlining at the default number of runs
+	// within the size limits above (see test/libsolidity/gasTests/abiv2_optimised.sol).
+	size_t addedBytes = 6 * m_functionSizes.at(_function.name);
+	// Constant arguments might provide a means for further optimization, so they cause a bonus.
+	if (_constantArguments)
+		addedBytes /= 2;
+
+	return callCosts >= m_meter->codeSizeCosts(addedBytes);
+}
+
 void FullInliner::updateCodeSize(FunctionDefinition const& _fun)
 {
 	m_functionSizes[_fun.name] = CodeSize::codeSize(_fun.body);
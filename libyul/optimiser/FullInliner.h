@@ -37,6 +37,7 @@ namespace yul
 {
 
 class NameCollector;
+class GasMeter;
 
 
 /**
@@ -63,13 +64,22 @@ class NameCollector;
  * code of f, with replacements: a -> f_a, b -> f_b, c -> f_c
  * let z := f_c
  *
+ * The functions are processed bottom-up along the strongly connected components
+ * of the call graph, so the size of a function is final when deciding whether
+ * to inline it into its callers. Calls inside a strongly connected component
+ * are never inlined.
+ *
+ * If a gas meter is given, the decision for functions that are neither tiny nor
+ * only called once weighs the costs of the call against the costs of the increased
+ * code size, taking the expected number of executions per deployment into account.
+ *
  * Prerequisites: Disambiguator
  * More efficient if run after: Function Hoister, Expression Splitter
  */
 class FullInliner: public ASTModifier
 {
 public:
-	explicit FullInliner(Block& _ast, NameDispenser& _dispenser);
+	explicit FullInliner(Block& _ast, NameDispenser& _dispenser, GasMeter const* _meter = nullptr);
 
 	void run();
 
@@ -91,6 +101,13 @@ public:
 	void tentativelyUpdateCodeSize(YulString _function, YulString _callSite);
 
 private:
+	/// Computes the strongly connected components of the call graph and
+	/// the order in which the functions are processed.
+	void determineComponents();
+	/// @returns true if the saved costs of the call outweigh the costs
+	/// of duplicating the body of the function. Requires a gas meter.
+	/// Only consulted for functions that exceed the fixed size limits.
+	bool inliningPays(FunctionDefinition const& _function, bool _constantArguments) const;
 	void updateCodeSize(FunctionDefinition const& _fun);
 	void handleBlock(YulString _currentFunctionName, Block& _block);
 	bool recursive(FunctionDefinition const& _fun) const;
@@ -104,7 +121,12 @@ private:
 	/// Variables that are constants (used for inlining heuristic)
 	std::set<YulString> m_constants;
 	std::map<YulString, size_t> m_functionSizes;
+	/// Index of the strongly connected component of the call graph for each function.
+	std::map<YulString, size_t> m_component;
+	/// Functions in bottom-up order, i.e. callees before callers.
+	std::vector<YulString> m_functionOrder;
 	NameDispenser& m_nameDispenser;
+	GasMeter const* m_meter = nullptr;
 };
 
 /**
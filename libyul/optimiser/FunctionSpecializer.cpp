@@ -0,0 +1,309 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Optimiser component that specializes functions for constant arguments.
+ */
+
+#include <libyul/optimiser/FunctionSpecializer.h>
+
+#include <libyul/optimiser/ASTWalker.h>
+#include <libyul/optimiser/BlockFlattener.h>
+#include <libyul/optimiser/EquivalentFunctionCombiner.h>
+#include <libyul/optimiser/ExpressionSimplifier.h>
+#include <libyul/optimiser/FullInliner.h>
+#include <libyul/optimiser/Metrics.h>
+#include <libyul/optimiser/NameCollector.h>
+#include <libyul/optimiser/NameDispenser.h>
+#include <libyul/optimiser/Semantics.h>
+#include <libyul/optimiser/SSAValueTracker.h>
+#include <libyul/optimiser/StructuralSimplifier.h>
+#include <libyul/optimiser/UnusedPruner.h>
+#include <libyul/AsmData.h>
+#include <libyul/Exceptions.h>
+#include <libyul/Utilities.h>
+
+#include <libdevcore/CommonData.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace dev;
+using namespace yul;
+
+namespace
+{
+
+/// @returns the constant values of the arguments of the function call.
+FunctionSpecializer::ArgumentConstants argumentConstants(
+	FunctionCall const& _funCall,
+	map<YulString, u256> const& _constants
+)
+{
+	FunctionSpecializer::ArgumentConstants result;
+	for (auto const& argument: _funCall.arguments)
+		if (argument.type() == typeid(Literal) && boost::get<Literal>(argument).kind == LiteralKind::Number)
+			result.emplace_back(valueOfNumberLiteral(boost::get<Literal>(argument)));
+		else if (argument.type() == typeid(Identifier) && _constants.count(boost::get<Identifier>(argument).name))
+			result.emplace_back(_constants.at(boost::get<Identifier>(argument).name));
+		else
+			result.emplace_back(boost::none);
+	return result;
+}
+
+bool hasConstant(FunctionSpecializer::ArgumentConstants const& _constants)
+{
+	return any_of(_constants.begin(), _constants.end(), [](boost::optional<u256> const& _c) { return !!_c; });
+}
+
+/**
+ * Counts how often each function is called with each combination of constant arguments.
+ */
+class CallCounter: public ASTWalker
+{
+public:
+	CallCounter(
+		map<YulString, FunctionDefinition const*> const& _functions,
+		map<YulString, u256> const& _constants
+	):
+		m_functions(_functions),
+		m_constants(_constants)
+	{}
+
+	using ASTWalker::operator();
+	void operator()(FunctionCall const& _funCall) override
+	{
+		ASTWalker::operator()(_funCall);
+		if (!m_functions.count(_funCall.functionName.name))
+			return;
+		FunctionSpecializer::ArgumentConstants constants = argumentConstants(_funCall, m_constants);
+		if (hasConstant(constants))
+			++m_counts[make_pair(_funCall.functionName.name, std::move(constants))];
+	}
+
+	map<pair<YulString, FunctionSpecializer::ArgumentConstants>, size_t> m_counts;
+
+private:
+	map<YulString, FunctionDefinition const*> const& m_functions;
+	map<YulString, u256> const& m_constants;
+};
+
+/**
+ * Redirects function calls to the specialized functions and removes
+ * the constant arguments.
+ */
+class CallRedirector: public ASTModifier
+{
+public:
+	CallRedirector(
+		map<pair<YulString, FunctionSpecializer::ArgumentConstants>, YulString> const& _specializations,
+		map<YulString, u256> const& _constants
+	):
+		m_specializations(_specializations),
+		m_constants(_constants)
+	{}
+
+	using ASTModifier::operator();
+	void operator()(FunctionCall& _funCall) override
+	{
+		ASTModifier::operator()(_funCall);
+		FunctionSpecializer::ArgumentConstants constants = argumentConstants(_funCall, m_constants);
+		auto it = m_specializations.find(make_pair(_funCall.functionName.name, constants));
+		if (it == m_specializations.end())
+			return;
+		_funCall.functionName.name = it->second;
+		// All removed arguments are literals or identifiers, so they can be removed
+		// without changing the semantics.
+		vector<Expression> arguments;
+		for (size_t i = 0; i < _funCall.arguments.size(); ++i)
+			if (!constants[i])
+				arguments.emplace_back(std::move(_funCall.arguments[i]));
+		_funCall.arguments = std::move(arguments);
+	}
+
+private:
+	map<pair<YulString, FunctionSpecializer::ArgumentConstants>, YulString> const& m_specializations;
+	map<YulString, u256> const& m_constants;
+};
+
+/**
+ * Copies the body of a function (see BodyCopier) and replaces references
+ * to the given variables by literals.
+ */
+class SpecializedBodyCopier: public BodyCopier
+{
+public:
+	SpecializedBodyCopier(
+		NameDispenser& _nameDispenser,
+		map<YulString, YulString> const& _variableReplacements,
+		map<YulString, Literal> const& _literals
+	):
+		BodyCopier(_nameDispenser, _variableReplacements),
+		m_literals(_literals)
+	{}
+
+	using BodyCopier::translate;
+	Expression translate(Expression const& _expression) override
+	{
+		if (_expression.type() == typeid(Identifier))
+		{
+			auto it = m_literals.find(boost::get<Identifier>(_expression).name);
+			if (it != m_literals.end())
+				return it->second;
+		}
+		return BodyCopier::translate(_expression);
+	}
+
+private:
+	map<YulString, Literal> const& m_literals;
+};
+
+}
+
+void FunctionSpecializer::run(
+	Dialect const& _dialect,
+	Block& _ast,
+	NameDispenser& _nameDispenser,
+	size_t _expectedExecutionsPerDeployment
+)
+{
+	// The copies are paid for once at deployment, but the savings occur at every
+	// execution. The limit prevents excessive code growth for very large values.
+	size_t budget = min<size_t>(_expectedExecutionsPerDeployment, 2000) / 4;
+	if (budget == 0)
+		return;
+
+	FunctionSpecializer specializer{_dialect, _ast, _nameDispenser};
+	specializer.specialize(budget);
+}
+
+FunctionSpecializer::FunctionSpecializer(Dialect const& _dialect, Block& _ast, NameDispenser& _nameDispenser):
+	m_dialect(_dialect),
+	m_ast(_ast),
+	m_nameDispenser(_nameDispenser)
+{
+	SSAValueTracker tracker;
+	tracker(m_ast);
+	for (auto const& ssaValue: tracker.values())
+		if (
+			ssaValue.second &&
+			ssaValue.second->type() == typeid(Literal) &&
+			boost::get<Literal>(*ssaValue.second).kind == LiteralKind::Number
+		)
+			m_constants[ssaValue.first] = valueOfNumberLiteral(boost::get<Literal>(*ssaValue.second));
+
+	for (auto const& statement: m_ast.statements)
+		if (statement.type() == typeid(FunctionDefinition))
+		{
+			FunctionDefinition const& fun = boost::get<FunctionDefinition>(statement);
+			m_functions[fun.name] = &fun;
+		}
+}
+
+void FunctionSpecializer::specialize(size_t _budget)
+{
+	CallCounter counter{m_functions, m_constants};
+	counter(m_ast);
+
+	// Only consider combinations that occur more than once, the most frequent first.
+	vector<pair<pair<YulString, ArgumentConstants>, size_t>> candidates;
+	for (auto& call: counter.m_counts)
+		if (call.second > 1)
+			candidates.emplace_back(call);
+	stable_sort(candidates.begin(), candidates.end(), [](auto const& _a, auto const& _b) {
+		return _a.second > _b.second;
+	});
+
+	bool allowMSizeOptimization = !SideEffectsCollector(m_dialect, m_ast).containsMSize();
+
+	vector<Statement> newFunctions;
+	size_t addedSize = 0;
+	for (auto const& candidate: candidates)
+	{
+		FunctionDefinition const& function = *m_functions.at(candidate.first.first);
+		FunctionDefinition copy = specializedCopy(function, candidate.first.second);
+		UnusedPruner::runUntilStabilised(m_dialect, copy, allowMSizeOptimization);
+
+		size_t size = CodeSize::codeSize(copy.body);
+		if (size >= CodeSize::codeSize(function.body) || addedSize + size > _budget)
+			continue;
+
+		addedSize += size;
+		m_specializations[candidate.first] = copy.name;
+		newFunctions.emplace_back(std::move(copy));
+	}
+
+	if (newFunctions.empty())
+		return;
+
+	CallRedirector{m_specializations, m_constants}(m_ast);
+	m_ast.statements += std::move(newFunctions);
+	EquivalentFunctionCombiner::run(m_ast);
+}
+
+FunctionDefinition FunctionSpecializer::specializedCopy(
+	FunctionDefinition const& _function,
+	ArgumentConstants const& _constants
+)
+{
+	yulAssert(_function.parameters.size() == _constants.size(), "");
+
+	Assignments assignments;
+	assignments(_function.body);
+	set<YulString> const& assignedVariables = assignments.names();
+
+	FunctionDefinition copy{_function.location, m_nameDispenser.newName(_function.name), {}, {}, {}};
+	map<YulString, YulString> variableReplacements;
+	map<YulString, Literal> literals;
+	vector<Statement> prologue;
+	auto newVariable = [&](TypedName const& _variable) {
+		YulString newName = m_nameDispenser.newName(_variable.name);
+		variableReplacements[_variable.name] = newName;
+		return TypedName{_variable.location, newName, _variable.type};
+	};
+
+	for (size_t i = 0; i < _constants.size(); ++i)
+	{
+		TypedName const& parameter = _function.parameters[i];
+		if (!_constants[i])
+			copy.parameters.emplace_back(newVariable(parameter));
+		else
+		{
+			Literal value{parameter.location, LiteralKind::Number, YulString{formatNumber(*_constants[i])}, parameter.type};
+			if (assignedVariables.count(parameter.name))
+				prologue.emplace_back(VariableDeclaration{
+					parameter.location,
+					{newVariable(parameter)},
+					make_unique<Expression>(std::move(value))
+				});
+			else
+				literals.emplace(parameter.name, std::move(value));
+		}
+	}
+	for (auto const& returnVariable: _function.returnVariables)
+		copy.returnVariables.emplace_back(newVariable(returnVariable));
+
+	copy.body = boost::get<Block>(SpecializedBodyCopier{m_nameDispenser, variableReplacements, literals}(_function.body));
+	copy.body.statements = std::move(prologue) + std::move(copy.body.statements);
+
+	// The simplifiers operate on blocks, so wrap the copy temporarily.
+	Block wrapper{copy.location, {}};
+	wrapper.statements.emplace_back(std::move(copy));
+	ExpressionSimplifier::run(m_dialect, wrapper);
+	StructuralSimplifier{m_dialect}(wrapper);
+	BlockFlattener{}(wrapper);
+	return std::move(boost::get<FunctionDefinition>(wrapper.statements.front()));
+}
@@ -0,0 +1,113 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Optimiser component that specializes functions for constant arguments.
+ */
+#pragma once
+
+#include <libyul/AsmDataForward.h>
+#include <libyul/YulString.h>
+
+#include <libdevcore/Common.h>
+
+#include <boost/optional.hpp>
+
+#include <map>
+#include <vector>
+
+namespace yul
+{
+struct Dialect;
+class NameDispenser;
+
+/**
+ * Optimiser component that creates copies of functions that are specialized
+ * for a recurring combination of constant arguments.
+ *
+ * If a function is called at least twice with the same constants for some
+ * of its arguments, a copy of the function without the respective parameters
+ * is created. References to the removed parameters are replaced by the constants
+ * (or, if the parameter is assigned to, it is turned into a variable declaration
+ * at the start of the body) and the copy is simplified using the
+ * ExpressionSimplifier, the StructuralSimplifier and the UnusedPruner.
+ * The copy is only kept if
+ * it is smaller than the original function, i.e. if the constants actually
+ * enable simplifications. The respective calls are then redirected to the copy
+ * and copies that turned out to be equivalent are combined using the
+ * EquivalentFunctionCombiner.
+ *
+ * Example:
+ *
+ *   function f(a, b) -> r { switch a case 0 { r := b } default { r := mul(a, b) } }
+ *   let x := f(0, calldataload(0))
+ *   let y := f(0, calldataload(32))
+ *
+ * is transformed into
+ *
+ *   function f(a, b) -> r { switch a case 0 { r := b } default { r := mul(a, b) } }
+ *   function f_1(b_2) -> r_3 { r_3 := b_2 }
+ *   let x := f_1(calldataload(0))
+ *   let y := f_1(calldataload(32))
+ *
+ * The original function is removed by the UnusedPruner later on if it is not
+ * used anymore.
+ *
+ * Since the copies increase the code size, the total size of the copies created
+ * in one run is bounded by a budget that grows with the expected number of
+ * executions per deployment.
+ *
+ * Arguments count as constant if they are number literals or variables that
+ * have a literal as value and are never re-assigned.
+ *
+ * Prerequisite: Disambiguator, ForLoopInitRewriter, FunctionHoister, FunctionGrouper
+ * Works best if run after the ExpressionSplitter in SSA form.
+ */
+class FunctionSpecializer
+{
+public:
+	static void run(
+		Dialect const& _dialect,
+		Block& _ast,
+		NameDispenser& _nameDispenser,
+		size_t _expectedExecutionsPerDeployment
+	);
+
+	/// Constant values of the arguments of a function call, boost::none for
+	/// arguments that are not constant.
+	using ArgumentConstants = std::vector<boost::optional<dev::u256>>;
+
+private:
+	FunctionSpecializer(Dialect const& _dialect, Block& _ast, NameDispenser& _nameDispenser);
+
+	/// Creates specialized copies of the functions for the most frequent combinations
+	/// of constant arguments as long as their total size does not exceed @a _budget.
+	void specialize(size_t _budget);
+	/// @returns a simplified copy of @a _function where the parameters that have
+	/// constant values according to @a _constants are removed.
+	FunctionDefinition specializedCopy(FunctionDefinition const& _function, ArgumentConstants const& _constants);
+
+	Dialect const& m_dialect;
+	Block& m_ast;
+	NameDispenser& m_nameDispenser;
+	/// Variables that are never re-assigned and have a number literal as value.
+	std::map<YulString, dev::u256> m_constants;
+	std::map<YulString, FunctionDefinition const*> m_functions;
+	/// Names of the specialized functions.
+	std::map<std::pair<YulString, ArgumentConstants>, YulString> m_specializations;
+};
+
+}
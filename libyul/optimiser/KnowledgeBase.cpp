@@ -22,16 +22,21 @@
 
 #include <libyul/AsmData.h>
 #include <libyul/Utilities.h>
+#include <libyul/optimiser/KnownBits.h>
 #include <libyul/optimiser/SimplificationRules.h>
 #include <libyul/optimiser/Semantics.h>
 
 #include <libdevcore/CommonData.h>
 
+using namespace std;
 using namespace yul;
 using namespace dev;
 
 bool KnowledgeBase::knownToBeDifferent(YulString _a, YulString _b)
 {
+	if (auto difference = constantDifference(_a, _b))
+		return *difference != 0;
+
 	// Try to use the simplification rules together with the
 	// current values to turn `sub(_a, _b)` into a nonzero constant.
 	// If that fails, try `eq(_a, _b)`.
@@ -44,11 +49,14 @@ bool KnowledgeBase::knownToBeDifferent(YulString _a, YulString _b)
 	if (expr2.type() == typeid(Literal))
 		return valueOfLiteral(boost::get<Literal>(expr2)) == 0;
 
-	return false;
+	return conflictingBits(_a, _b);
 }
 
 bool KnowledgeBase::knownToBeDifferentByAtLeast32(YulString _a, YulString _b)
 {
+	if (auto difference = constantDifference(_a, _b))
+		return *difference >= 32 && *difference <= u256(0) - 32;
+
 	// Try to use the simplification rules together with the
 	// current values to turn `sub(_a, _b)` into a constant whose absolute value is at least 32.
 
@@ -59,13 +67,26 @@ bool KnowledgeBase::knownToBeDifferentByAtLeast32(YulString _a, YulString _b)
 		return val >= 32 && val <= u256(0) - 32;
 	}
 
-	return false;
+	// Two different multiples of 32 differ by at least 32.
+	KnownBitsAnalyzer analyzer{m_dialect, m_variableValues};
+	return
+		analyzer.knownBits(_a).trailingZeros() >= 5 &&
+		analyzer.knownBits(_b).trailingZeros() >= 5 &&
+		conflictingBits(_a, _b);
+}
+
+bool KnowledgeBase::conflictingBits(YulString _a, YulString _b) const
+{
+	KnownBitsAnalyzer analyzer{m_dialect, m_variableValues};
+	KnownBits a = analyzer.knownBits(_a);
+	KnownBits b = analyzer.knownBits(_b);
+	return (a.ones & b.zeros) != 0 || (a.zeros & b.ones) != 0;
 }
 
 Expression KnowledgeBase::simplify(Expression _expression)
 {
 	bool startedRecursion = (m_recursionCounter == 0);
-	dev::ScopeGuard{[&] { if (startedRecursion) m_recursionCounter = 0; }};
+	dev::ScopeGuard guard{[&] { if (startedRecursion) m_recursionCounter = 0; }};
 
 	if (startedRecursion)
 		m_recursionCounter = 100;
@@ -86,3 +107,72 @@ Expression KnowledgeBase::simplify(Expression _expression)
 
 	return _expression;
 }
+
+pair<YulString, u256> KnowledgeBase::baseAndOffset(YulString _variable) const
+{
+	auto valueOf = [&](YulString _name) -> Expression const* {
+		auto it = m_variableValues.find(_name);
+		return it == m_variableValues.end() ? nullptr : it->second;
+	};
+	// @returns the value of a literal or of a variable whose value is a literal.
+	auto constantValue = [&](Expression const& _expression) -> boost::optional<u256> {
+		Expression const* expression = &_expression;
+		if (expression->type() == typeid(Identifier))
+			expression = valueOf(boost::get<Identifier>(*expression).name);
+		if (expression && expression->type() == typeid(Literal))
+			return valueOfLiteral(boost::get<Literal>(*expression));
+		return boost::none;
+	};
+
+	u256 offset = 0;
+	// Bound the number of steps, chains of additions are usually short.
+	for (size_t steps = 0; steps < 16; ++steps)
+	{
+		Expression const* value = valueOf(_variable);
+		if (!value)
+			break;
+		if (value->type() == typeid(Identifier))
+			_variable = boost::get<Identifier>(*value).name;
+		else if (value->type() == typeid(Literal))
+			return {YulString{}, offset + valueOfLiteral(boost::get<Literal>(*value))};
+		else if (value->type() == typeid(FunctionCall))
+		{
+			FunctionCall const& funCall = boost::get<FunctionCall>(*value);
+			if (funCall.arguments.size() != 2)
+				break;
+			Expression const& first = funCall.arguments.at(0);
+			Expression const& second = funCall.arguments.at(1);
+			boost::optional<u256> firstValue = constantValue(first);
+			boost::optional<u256> secondValue = constantValue(second);
+			if (funCall.functionName.name == "add"_yulstring && secondValue && first.type() == typeid(Identifier))
+			{
+				offset += *secondValue;
+				_variable = boost::get<Identifier>(first).name;
+			}
+			else if (funCall.functionName.name == "add"_yulstring && firstValue && second.type() == typeid(Identifier))
+			{
+				offset += *firstValue;
+				_variable = boost::get<Identifier>(second).name;
+			}
+			else if (funCall.functionName.name == "sub"_yulstring && secondValue && first.type() == typeid(Identifier))
+			{
+				offset -= *secondValue;
+				_variable = boost::get<Identifier>(first).name;
+			}
+			else
+				break;
+		}
+		else
+			break;
+	}
+	return {_variable, offset};
+}
+
+boost::optional<u256> KnowledgeBase::constantDifference(YulString _a, YulString _b) const
+{
+	pair<YulString, u256> a = baseAndOffset(_a);
+	pair<YulString, u256> b = baseAndOffset(_b);
+	if (a.first != b.first)
+		return boost::none;
+	return a.second - b.second;
+}
@@ -22,7 +22,13 @@
 
 #include <libyul/AsmDataForward.h>
 #include <libyul/YulString.h>
+
+#include <libdevcore/Common.h>
+
+#include <boost/optional.hpp>
+
 #include <map>
+#include <utility>
 
 namespace yul
 {
@@ -45,9 +51,18 @@ public:
 	bool knownToBeDifferent(YulString _a, YulString _b);
 	bool knownToBeDifferentByAtLeast32(YulString _a, YulString _b);
 	bool knownToBeEqual(YulString _a, YulString _b) const { return _a == _b; }
+	/// @returns the difference of the values of @a _a and @a _b if it is a constant.
+	boost::optional<dev::u256> constantDifference(YulString _a, YulString _b) const;
 
 private:
 	Expression simplify(Expression _expression);
+	/// @returns a variable (or the empty string for constants) and an offset such that
+	/// the current value of @a _variable is known to be the value of that variable plus the offset.
+	/// Follows the values of variables through additions and subtractions of constants.
+	std::pair<YulString, dev::u256> baseAndOffset(YulString _variable) const;
+	/// @returns true if a bit is known to be set in the value of one variable
+	/// and known to be cleared in the value of the other.
+	bool conflictingBits(YulString _a, YulString _b) const;
 
 	Dialect const& m_dialect;
 	std::map<YulString, Expression const*> const& m_variableValues;
@@ -0,0 +1,375 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Analysis that determines which bits of the values of expressions are known.
+ */
+
+#include <libyul/optimiser/KnownBits.h>
+
+#include <libyul/optimiser/Semantics.h>
+#include <libyul/optimiser/SimplificationRules.h>
+#include <libyul/AsmData.h>
+#include <libyul/Utilities.h>
+
+#include <libdevcore/CommonData.h>
+
+using namespace std;
+using namespace dev;
+using namespace yul;
+
+namespace
+{
+
+/// @returns a mask of the @a _bits least significant bits.
+u256 lowMask(unsigned _bits)
+{
+	if (_bits >= 256)
+		return ~u256(0);
+	return (u256(1) << _bits) - 1;
+}
+
+/// @returns the number of bits needed to represent @a _value.
+unsigned bitLength(u256 const& _value)
+{
+	if (_value == 0)
+		return 0;
+	return unsigned(boost::multiprecision::msb(_value)) + 1;
+}
+
+/// @returns the known bits of a value that is at most @a _maxValue and a multiple
+/// of 2 to the power of @a _trailingZeros.
+KnownBits boundedBits(u256 const& _maxValue, unsigned _trailingZeros)
+{
+	return KnownBits{~lowMask(bitLength(_maxValue)) | lowMask(_trailingZeros), 0};
+}
+
+Literal literal(langutil::SourceLocation const& _location, u256 const& _value)
+{
+	return Literal{_location, LiteralKind::Number, YulString{formatNumber(_value)}, {}};
+}
+
+}
+
+unsigned KnownBits::trailingZeros() const
+{
+	if (zeros == ~u256(0))
+		return 256;
+	return unsigned(boost::multiprecision::lsb(~zeros));
+}
+
+KnownBits KnownBitsAnalyzer::knownBits(Expression const& _expression)
+{
+	// Each query may visit at most this many expressions.
+	m_budget = 64;
+	return compute(_expression);
+}
+
+KnownBits KnownBitsAnalyzer::knownBits(YulString _variable)
+{
+	return knownBits(Identifier{{}, _variable});
+}
+
+boost::optional<Expression> KnownBitsAnalyzer::simplify(Expression const& _expression)
+{
+	auto instruction = SimplificationRules::instructionAndArguments(m_dialect, _expression);
+	if (!instruction)
+		return boost::none;
+	vector<Expression> const& arguments = *instruction->second;
+	langutil::SourceLocation location = locationOf(_expression);
+
+	KnownBits result = knownBits(_expression);
+	if (result.isConstant())
+	{
+		if (movable(_expression))
+			return {literal(location, result.ones)};
+		return boost::none;
+	}
+
+	switch (instruction->first)
+	{
+	case dev::eth::Instruction::AND:
+		for (size_t i = 0; i < 2; ++i)
+		{
+			// The mask operand is removed, so it has to be free of side effects.
+			if (arguments[i].type() != typeid(Literal) && !movable(arguments[i]))
+				continue;
+			KnownBits mask = knownBits(arguments[i]);
+			if (!mask.isConstant())
+				continue;
+			if (auto masked = applyMask(arguments[1 - i], mask.ones, location))
+				return masked;
+		}
+		break;
+	case dev::eth::Instruction::SIGNEXTEND:
+		if (arguments[0].type() == typeid(Literal))
+		{
+			u256 byteIndex = valueOfLiteral(boost::get<Literal>(arguments[0]));
+			if (byteIndex < 31)
+			{
+				// The value does not change if the sign bit and all bits above are zero.
+				u256 highBits = ~lowMask(unsigned(byteIndex) * 8 + 7);
+				if ((knownBits(arguments[1]).zeros & highBits) == highBits)
+					return {arguments[1]};
+			}
+		}
+		break;
+	case dev::eth::Instruction::ISZERO:
+		// iszero(iszero(x)) is x if x is known to be zero or one.
+		if (Expression const* inner = resolve(arguments[0]))
+			if (auto innerInstruction = SimplificationRules::instructionAndArguments(m_dialect, *inner))
+				if (innerInstruction->first == dev::eth::Instruction::ISZERO)
+				{
+					Expression const& value = innerInstruction->second->at(0);
+					if (
+						(value.type() == typeid(Identifier) || value.type() == typeid(Literal)) &&
+						knownBits(value).maxValue() <= 1
+					)
+						return {value};
+				}
+		break;
+	default:
+		break;
+	}
+	return boost::none;
+}
+
+boost::optional<Expression> KnownBitsAnalyzer::applyMask(
+	Expression const& _expression,
+	u256 const& _mask,
+	langutil::SourceLocation const& _location
+)
+{
+	// Remove masks that do not clear any bit that can be set.
+	if ((knownBits(_expression).maxValue() & ~_mask) == 0)
+		return {_expression};
+
+	Expression const* value = resolve(_expression);
+	if (!value)
+		return boost::none;
+	auto instruction = SimplificationRules::instructionAndArguments(m_dialect, *value);
+	if (!instruction)
+		return boost::none;
+	vector<Expression> const& arguments = *instruction->second;
+	if (instruction->first == dev::eth::Instruction::AND)
+	{
+		// Combine nested masks.
+		for (size_t i = 0; i < 2; ++i)
+		{
+			if (arguments[i].type() != typeid(Literal) && !movable(arguments[i]))
+				continue;
+			KnownBits innerMask = knownBits(arguments[i]);
+			if (innerMask.isConstant())
+				return {FunctionalInstruction{_location, dev::eth::Instruction::AND, {
+					arguments[1 - i],
+					literal(_location, innerMask.ones & _mask)
+				}}};
+		}
+	}
+	else if (instruction->first == dev::eth::Instruction::OR)
+	{
+		// Apply the mask to both operands, which is only beneficial
+		// if this does not result in two masks. This combines the masks
+		// of sequences of updates of parts of the same value, for example
+		// of packed storage variables.
+		auto first = applyMask(arguments[0], _mask, _location);
+		auto second = first ? applyMask(arguments[1], _mask, _location) : boost::none;
+		if (first && second)
+			return {FunctionalInstruction{_location, dev::eth::Instruction::OR, {
+				std::move(*first),
+				std::move(*second)
+			}}};
+	}
+	return boost::none;
+}
+
+KnownBits KnownBitsAnalyzer::compute(Expression const& _expression)
+{
+	if (m_budget == 0)
+		return KnownBits::unknown();
+	--m_budget;
+
+	if (_expression.type() == typeid(Literal))
+	{
+		Literal const& literal = boost::get<Literal>(_expression);
+		if (literal.kind == LiteralKind::String && literal.value.str().size() > 32)
+			return KnownBits::unknown();
+		return KnownBits::constant(valueOfLiteral(literal));
+	}
+	else if (_expression.type() == typeid(Identifier))
+	{
+		auto it = m_variableValues.find(boost::get<Identifier>(_expression).name);
+		if (it != m_variableValues.end() && it->second)
+			return compute(*it->second);
+		return KnownBits::unknown();
+	}
+
+	auto instruction = SimplificationRules::instructionAndArguments(m_dialect, _expression);
+	if (!instruction)
+		return KnownBits::unknown();
+	vector<Expression> const& arguments = *instruction->second;
+
+	switch (instruction->first)
+	{
+	case dev::eth::Instruction::AND:
+	{
+		KnownBits a = compute(arguments[0]);
+		KnownBits b = compute(arguments[1]);
+		return KnownBits{a.zeros | b.zeros, a.ones & b.ones};
+	}
+	case dev::eth::Instruction::OR:
+	{
+		KnownBits a = compute(arguments[0]);
+		KnownBits b = compute(arguments[1]);
+		return KnownBits{a.zeros & b.zeros, a.ones | b.ones};
+	}
+	case dev::eth::Instruction::XOR:
+	{
+		KnownBits a = compute(arguments[0]);
+		KnownBits b = compute(arguments[1]);
+		return KnownBits{(a.zeros & b.zeros) | (a.ones & b.ones), (a.zeros & b.ones) | (a.ones & b.zeros)};
+	}
+	case dev::eth::Instruction::NOT:
+	{
+		KnownBits a = compute(arguments[0]);
+		return KnownBits{a.ones, a.zeros};
+	}
+	case dev::eth::Instruction::SHL:
+	case dev::eth::Instruction::SHR:
+	{
+		KnownBits shift = compute(arguments[0]);
+		if (!shift.isConstant())
+			return KnownBits::unknown();
+		if (shift.ones >= 256)
+			return KnownBits::constant(0);
+		unsigned amount = unsigned(shift.ones);
+		KnownBits value = compute(arguments[1]);
+		if (instruction->first == dev::eth::Instruction::SHL)
+			return KnownBits{(value.zeros << amount) | lowMask(amount), value.ones << amount};
+		else
+			return KnownBits{(value.zeros >> amount) | ~(~u256(0) >> amount), value.ones >> amount};
+	}
+	case dev::eth::Instruction::SIGNEXTEND:
+	{
+		KnownBits byteIndex = compute(arguments[0]);
+		KnownBits value = compute(arguments[1]);
+		if (!byteIndex.isConstant())
+			return KnownBits::unknown();
+		if (byteIndex.ones >= 31)
+			return value;
+		unsigned signBit = unsigned(byteIndex.ones) * 8 + 7;
+		u256 lowBits = lowMask(signBit + 1);
+		KnownBits result{value.zeros & lowBits, value.ones & lowBits};
+		if (boost::multiprecision::bit_test(value.zeros, signBit))
+			result.zeros |= ~lowBits;
+		else if (boost::multiprecision::bit_test(value.ones, signBit))
+			result.ones |= ~lowBits;
+		return result;
+	}
+	case dev::eth::Instruction::BYTE:
+		return boundedBits(0xff, 0);
+	case dev::eth::Instruction::LT:
+	case dev::eth::Instruction::GT:
+	{
+		KnownBits a = compute(arguments[0]);
+		KnownBits b = compute(arguments[1]);
+		if (instruction->first == dev::eth::Instruction::GT)
+			swap(a, b);
+		if (a.maxValue() < b.minValue())
+			return KnownBits::constant(1);
+		if (a.minValue() >= b.maxValue())
+			return KnownBits::constant(0);
+		return boundedBits(1, 0);
+	}
+	case dev::eth::Instruction::EQ:
+	{
+		KnownBits a = compute(arguments[0]);
+		KnownBits b = compute(arguments[1]);
+		if ((a.ones & b.zeros) != 0 || (a.zeros & b.ones) != 0)
+			return KnownBits::constant(0);
+		return boundedBits(1, 0);
+	}
+	case dev::eth::Instruction::ISZERO:
+	{
+		KnownBits a = compute(arguments[0]);
+		if (a.ones != 0)
+			return KnownBits::constant(0);
+		if (a.maxValue() == 0)
+			return KnownBits::constant(1);
+		return boundedBits(1, 0);
+	}
+	case dev::eth::Instruction::SLT:
+	case dev::eth::Instruction::SGT:
+		return boundedBits(1, 0);
+	case dev::eth::Instruction::ADD:
+	{
+		KnownBits a = compute(arguments[0]);
+		KnownBits b = compute(arguments[1]);
+		unsigned trailingZeros = min(a.trailingZeros(), b.trailingZeros());
+		u256 maxValue = a.maxValue() + b.maxValue();
+		if (maxValue < a.maxValue())
+			// The addition can overflow.
+			return boundedBits(~u256(0), trailingZeros);
+		return boundedBits(maxValue, trailingZeros);
+	}
+	case dev::eth::Instruction::SUB:
+	{
+		KnownBits a = compute(arguments[0]);
+		KnownBits b = compute(arguments[1]);
+		return boundedBits(~u256(0), min(a.trailingZeros(), b.trailingZeros()));
+	}
+	case dev::eth::Instruction::MUL:
+	{
+		KnownBits a = compute(arguments[0]);
+		KnownBits b = compute(arguments[1]);
+		unsigned trailingZeros = min(a.trailingZeros() + b.trailingZeros(), 256u);
+		if (bitLength(a.maxValue()) + bitLength(b.maxValue()) > 256)
+			return boundedBits(~u256(0), trailingZeros);
+		return boundedBits(a.maxValue() * b.maxValue(), trailingZeros);
+	}
+	case dev::eth::Instruction::DIV:
+		return boundedBits(compute(arguments[0]).maxValue(), 0);
+	case dev::eth::Instruction::MOD:
+	{
+		KnownBits a = compute(arguments[0]);
+		KnownBits b = compute(arguments[1]);
+		// The result is smaller than the divisor (or zero if it is zero).
+		return boundedBits(min(a.maxValue(), b.maxValue()), 0);
+	}
+	case dev::eth::Instruction::ADDRESS:
+	case dev::eth::Instruction::CALLER:
+	case dev::eth::Instruction::ORIGIN:
+	case dev::eth::Instruction::COINBASE:
+		return boundedBits(lowMask(160), 0);
+	default:
+		return KnownBits::unknown();
+	}
+}
+
+Expression const* KnownBitsAnalyzer::resolve(Expression const& _expression) const
+{
+	if (_expression.type() == typeid(Identifier))
+	{
+		auto it = m_variableValues.find(boost::get<Identifier>(_expression).name);
+		return it == m_variableValues.end() ? nullptr : it->second;
+	}
+	return &_expression;
+}
+
+bool KnownBitsAnalyzer::movable(Expression const& _expression) const
+{
+	return SideEffectsCollector(m_dialect, _expression).movable();
+}
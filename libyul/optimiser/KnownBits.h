@@ -0,0 +1,108 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Analysis that determines which bits of the values of expressions are known.
+ */
+
+#pragma once
+
+#include <libyul/AsmDataForward.h>
+#include <libyul/YulString.h>
+
+#include <liblangutil/SourceLocation.h>
+
+#include <libdevcore/Common.h>
+
+#include <boost/optional.hpp>
+
+#include <map>
+
+namespace yul
+{
+struct Dialect;
+
+/**
+ * Bits of a value that are known to be zero or known to be one.
+ * Since a value is at most the value with all bits set that are not known to be zero
+ * and at least the value with only the bits set that are known to be one, this
+ * also provides a range for the value.
+ */
+struct KnownBits
+{
+	dev::u256 zeros;
+	dev::u256 ones;
+
+	static KnownBits unknown() { return KnownBits{0, 0}; }
+	static KnownBits constant(dev::u256 const& _value) { return KnownBits{~_value, _value}; }
+
+	bool isConstant() const { return (zeros | ones) == ~dev::u256(0); }
+	dev::u256 maxValue() const { return ~zeros; }
+	dev::u256 minValue() const { return ones; }
+	/// @returns the number of least significant bits that are known to be zero.
+	unsigned trailingZeros() const;
+};
+
+/**
+ * Determines the known bits of expressions involving EVM instructions, literals
+ * and variables, where the values of variables are taken from the provided map
+ * (usually the current values of the DataFlowAnalyzer).
+ *
+ * Can also simplify expressions based on the known bits, for example it removes
+ * masks that do not clear any bit that can be set, combines the masks of nested
+ * partial updates of a value and evaluates comparisons whose outcome is
+ * determined by the ranges of the operands.
+ *
+ * The reference to the map of values provided at construction is assumed to be updating.
+ */
+class KnownBitsAnalyzer
+{
+public:
+	KnownBitsAnalyzer(Dialect const& _dialect, std::map<YulString, Expression const*> const& _variableValues):
+		m_dialect(_dialect),
+		m_variableValues(_variableValues)
+	{}
+
+	KnownBits knownBits(Expression const& _expression);
+	KnownBits knownBits(YulString _variable);
+
+	/// @returns an equivalent expression that is simpler than @a _expression according
+	/// to the known bits of its arguments or boost::none if there is none.
+	/// Only removes parts of the expression that are movable.
+	boost::optional<Expression> simplify(Expression const& _expression);
+
+private:
+	KnownBits compute(Expression const& _expression);
+	/// @returns an expression equivalent to `and(_expression, _mask)` that does not
+	/// need more masks than @a _expression or boost::none if there is none.
+	boost::optional<Expression> applyMask(
+		Expression const& _expression,
+		dev::u256 const& _mask,
+		langutil::SourceLocation const& _location
+	);
+	/// @returns the current value of @a _expression if it is a variable, the expression itself
+	/// if it is not a variable and nullptr if the value is unknown.
+	Expression const* resolve(Expression const& _expression) const;
+	bool movable(Expression const& _expression) const;
+
+	Dialect const& m_dialect;
+	std::map<YulString, Expression const*> const& m_variableValues;
+	/// Number of expressions that can still be visited in the current query.
+	/// Bounds the costs of following the values of variables.
+	size_t m_budget = 0;
+};
+
+}
@@ -24,6 +24,10 @@
 #include <libyul/backends/evm/EVMDialect.h>
 #include <libyul/optimiser/Semantics.h>
 #include <libyul/AsmData.h>
+#include <libyul/Utilities.h>
+
+#include <libdevcore/CommonData.h>
+#include <libdevcore/Keccak256.h>
 
 using namespace std;
 using namespace dev;
@@ -31,6 +35,9 @@ using namespace yul;
 
 void LoadResolver::run(Dialect const& _dialect, Block& _ast)
 {
+	// Loads and stores are only tracked for EVM dialects.
+	if (!dynamic_cast<EVMDialect const*>(&_dialect))
+		return;
 	bool containsMSize = SideEffectsCollector(_dialect, _ast).containsMSize();
 	LoadResolver{_dialect, !containsMSize}(_ast);
 }
@@ -61,6 +68,52 @@ void LoadResolver::visit(Expression& _e)
 					_e = Identifier{locationOf(_e), m_memory.values[key]};
 					return;
 				}
+				else if (
+					m_optimizeMLoad &&
+					builtin->instruction == dev::eth::Instruction::KECCAK256
+				)
+					if (auto hash = keccakOfKnownMemory(key, funCall.arguments.at(1)))
+					{
+						_e = Literal{locationOf(_e), LiteralKind::Number, YulString{formatNumber(*hash)}, {}};
+						return;
+					}
+			}
+	}
+}
+
+boost::optional<u256> LoadResolver::keccakOfKnownMemory(YulString _start, Expression const& _length)
+{
+	auto constantValue = [&](Expression const& _expression) -> boost::optional<u256> {
+		Expression const* expression = &_expression;
+		if (expression->type() == typeid(Identifier))
+		{
+			auto it = m_value.find(boost::get<Identifier>(*expression).name);
+			expression = it == m_value.end() ? nullptr : it->second;
+		}
+		if (expression && expression->type() == typeid(Literal))
+			return valueOfLiteral(boost::get<Literal>(*expression));
+		return boost::none;
+	};
+
+	boost::optional<u256> length = constantValue(_length);
+	// Only consider short areas, as for the libevmasm optimizer.
+	if (!length || *length > 128)
+		return boost::none;
+
+	bytes data;
+	for (u256 offset = 0; offset < *length; offset += 32)
+	{
+		boost::optional<u256> word;
+		for (auto const& keyAndValue: m_memory.values)
+			if (m_knowledgeBase.constantDifference(keyAndValue.first, _start) == offset)
+			{
+				word = constantValue(Identifier{{}, keyAndValue.second});
+				break;
 			}
+		if (!word)
+			return boost::none;
+		data += toBigEndian(*word);
 	}
+	data.resize(size_t(*length));
+	return u256(dev::keccak256(data));
 }
@@ -32,6 +32,9 @@ struct EVMDialect;
  * Optimisation stage that replaces expressions of type ``sload(x)`` and ``mload(x)`` by the value
  * currently stored in storage resp. memory, if known.
  *
+ * Also replaces ``keccak256(x, l)`` by its value if ``l`` is a constant of at most 128
+ * and the contents of all memory words in that range are known constants.
+ *
  * Works best if the code is in SSA form.
  *
  * Prerequisite: Disambiguator, ForLoopInitRewriter.
@@ -51,6 +54,10 @@ protected:
 	using ASTModifier::visit;
 	void visit(Expression& _e) override;
 
+	/// @returns the hash of the @a _length bytes of memory starting at @a _start if
+	/// the length is a small constant and all memory words in the range are known constants.
+	boost::optional<dev::u256> keccakOfKnownMemory(YulString _start, Expression const& _length);
+
 	bool m_optimizeMLoad = false;
 };
 
@@ -0,0 +1,166 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libyul/optimiser/LoopInvariantCodeMotion.h>
+
+#include <libyul/optimiser/NameCollector.h>
+#include <libyul/optimiser/Semantics.h>
+#include <libyul/backends/evm/EVMDialect.h>
+#include <libyul/AsmData.h>
+#include <libyul/Exceptions.h>
+
+#include <libevmasm/SemanticInformation.h>
+
+#include <libdevcore/CommonData.h>
+
+using namespace std;
+using namespace dev;
+using namespace yul;
+
+namespace
+{
+
+/**
+ * Checks whether an expression only depends on its referenced variables and on storage,
+ * i.e. whether it consists of movable operations and ``sload``.
+ */
+class StorageReadChecker: public ASTWalker
+{
+public:
+	StorageReadChecker(Dialect const& _dialect, Expression const& _expression): m_dialect(_dialect)
+	{
+		visit(_expression);
+	}
+
+	using ASTWalker::operator();
+	void operator()(FunctionalInstruction const& _instr) override
+	{
+		ASTWalker::operator()(_instr);
+		check(_instr.instruction);
+	}
+	void operator()(FunctionCall const& _functionCall) override
+	{
+		ASTWalker::operator()(_functionCall);
+		BuiltinFunction const* builtin = m_dialect.builtin(_functionCall.functionName.name);
+		if (!builtin)
+			m_valid = false;
+		else if (!builtin->movable)
+		{
+			auto const* evmDialect = dynamic_cast<EVMDialect const*>(&m_dialect);
+			BuiltinFunctionForEVM const* evmBuiltin = evmDialect ? evmDialect->builtin(builtin->name) : nullptr;
+			if (evmBuiltin && evmBuiltin->instruction)
+				check(*evmBuiltin->instruction);
+			else
+				m_valid = false;
+		}
+	}
+
+	bool valid() const { return m_valid; }
+
+private:
+	void check(dev::eth::Instruction _instruction)
+	{
+		if (_instruction != dev::eth::Instruction::SLOAD && !dev::eth::SemanticInformation::movable(_instruction))
+			m_valid = false;
+	}
+
+	Dialect const& m_dialect;
+	bool m_valid = true;
+};
+
+}
+
+void LoopInvariantCodeMotion::run(Dialect const& _dialect, Block& _ast)
+{
+	LoopInvariantCodeMotion{_dialect}(_ast);
+}
+
+void LoopInvariantCodeMotion::operator()(Block& _block)
+{
+	iterateReplacing(
+		_block.statements,
+		[&](Statement& _s) -> boost::optional<vector<Statement>>
+		{
+			visit(_s);
+			if (_s.type() == typeid(ForLoop))
+				return rewriteLoop(boost::get<ForLoop>(_s));
+			else
+				return {};
+		}
+	);
+}
+
+bool LoopInvariantCodeMotion::canBePromoted(
+	VariableDeclaration const& _varDecl,
+	set<YulString> const& _varsDefinedInCurrentScope,
+	set<YulString> const& _varsAssignedInLoop,
+	SideEffectsCollector const& _loopEffects
+) const
+{
+	for (auto const& var: _varDecl.variables)
+		if (_varsAssignedInLoop.count(var.name))
+			return false;
+	if (!_varDecl.value)
+		return true;
+
+	for (auto const& ref: ReferencesCounter::countReferences(*_varDecl.value))
+		if (_varsDefinedInCurrentScope.count(ref.first) || _varsAssignedInLoop.count(ref.first))
+			return false;
+
+	if (MovableChecker{m_dialect, *_varDecl.value}.movable())
+		return true;
+	// Storage reads cannot fail, so they can be executed even if the loop body is not.
+	return !_loopEffects.invalidatesStorage() && StorageReadChecker{m_dialect, *_varDecl.value}.valid();
+}
+
+boost::optional<vector<Statement>> LoopInvariantCodeMotion::rewriteLoop(ForLoop& _for)
+{
+	assertThrow(_for.pre.statements.empty(), OptimizerException, "ForLoopInitRewriter has to be run first.");
+
+	SideEffectsCollector loopEffects{m_dialect};
+	loopEffects(_for);
+	Assignments assignments;
+	assignments(_for);
+
+	vector<Statement> replacement;
+	for (Block* block: {&_for.post, &_for.body})
+	{
+		set<YulString> varsDefinedInScope;
+		iterateReplacing(
+			block->statements,
+			[&](Statement& _s) -> boost::optional<vector<Statement>>
+			{
+				if (_s.type() == typeid(VariableDeclaration))
+				{
+					VariableDeclaration const& varDecl = boost::get<VariableDeclaration>(_s);
+					if (canBePromoted(varDecl, varsDefinedInScope, assignments.names(), loopEffects))
+					{
+						replacement.emplace_back(std::move(_s));
+						return vector<Statement>{};
+					}
+					for (auto const& var: varDecl.variables)
+						varsDefinedInScope.insert(var.name);
+				}
+				return {};
+			}
+		);
+	}
+	if (replacement.empty())
+		return {};
+	replacement.emplace_back(std::move(_for));
+	return { std::move(replacement) };
+}
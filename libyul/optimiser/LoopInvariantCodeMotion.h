@@ -0,0 +1,84 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <libyul/optimiser/ASTWalker.h>
+#include <libyul/YulString.h>
+
+#include <boost/optional.hpp>
+
+#include <set>
+
+namespace yul
+{
+struct Dialect;
+class SideEffectsCollector;
+
+/**
+ * Loop-invariant code motion.
+ *
+ * Moves variable declarations out of the body and the post block of a for loop
+ * and in front of the loop, if their value does not change between iterations.
+ * This is the case if
+ *  - the declared variables are not re-assigned inside the loop,
+ *  - the value only references variables that are declared outside of the loop
+ *    and are not assigned to inside the loop and
+ *  - the value is movable or only reads from storage and the loop cannot modify storage.
+ *
+ * Example:
+ *
+ *   for { } lt(i, n) { i := add(i, 1) } { let x := mul(n, 32) let y := sload(x) mstore(i, y) }
+ *
+ * is transformed to
+ *
+ *   let x := mul(n, 32)
+ *   let y := sload(x)
+ *   for { } lt(i, n) { i := add(i, 1) } { mstore(i, y) }
+ *
+ * Inner loops are processed first, so declarations can move out of several loops.
+ * Works best if the code is in SSA form.
+ *
+ * Prerequisite: Disambiguator, ForLoopInitRewriter, FunctionHoister.
+ */
+class LoopInvariantCodeMotion: public ASTModifier
+{
+public:
+	static void run(Dialect const& _dialect, Block& _ast);
+
+	using ASTModifier::operator();
+	void operator()(Block& _block) override;
+
+private:
+	explicit LoopInvariantCodeMotion(Dialect const& _dialect): m_dialect(_dialect) {}
+
+	/// @returns true if the declaration can be moved in front of the loop.
+	/// @param _varsDefinedInCurrentScope variables declared in the loop block before the declaration.
+	/// @param _varsAssignedInLoop variables assigned to anywhere inside the loop.
+	bool canBePromoted(
+		VariableDeclaration const& _varDecl,
+		std::set<YulString> const& _varsDefinedInCurrentScope,
+		std::set<YulString> const& _varsAssignedInLoop,
+		SideEffectsCollector const& _loopEffects
+	) const;
+	/// @returns the loop-invariant declarations of the loop followed by the loop itself
+	/// or nothing if there are no loop-invariant declarations.
+	boost::optional<std::vector<Statement>> rewriteLoop(ForLoop& _for);
+
+	Dialect const& m_dialect;
+};
+
+}
@@ -0,0 +1,178 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Optimiser component that moves expressions that are computed on all paths
+ * through an if or switch statement in front of it.
+ */
+
+#include <libyul/optimiser/PartialRedundancyEliminator.h>
+
+#include <libyul/optimiser/BlockHasher.h>
+#include <libyul/optimiser/NameCollector.h>
+#include <libyul/optimiser/NameDispenser.h>
+#include <libyul/optimiser/Semantics.h>
+#include <libyul/optimiser/SyntacticalEquality.h>
+#include <libyul/AsmData.h>
+
+#include <libdevcore/CommonData.h>
+
+#include <boost/optional.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace yul;
+
+void PartialRedundancyEliminator::run(Dialect const& _dialect, Block& _ast, NameDispenser& _nameDispenser)
+{
+	Assignments assignments;
+	assignments(_ast);
+	PartialRedundancyEliminator{_dialect, _nameDispenser, assignments.names()}(_ast);
+}
+
+void PartialRedundancyEliminator::operator()(Block& _block)
+{
+	// Process the nested blocks first, so that the expressions they move
+	// to their top level can be moved further.
+	ASTModifier::operator()(_block);
+
+	m_declaredAt.clear();
+	for (size_t i = 0; i < _block.statements.size(); ++i)
+	{
+		NameCollector collector{Block{}};
+		collector.visit(_block.statements[i]);
+		for (YulString name: collector.names())
+			m_declaredAt[name] = i;
+	}
+
+	vector<Statement> statements;
+	for (size_t i = 0; i < _block.statements.size(); ++i)
+	{
+		statements += hoist(_block.statements, i);
+		statements.emplace_back(std::move(_block.statements[i]));
+	}
+	_block.statements = std::move(statements);
+}
+
+vector<VariableDeclaration*> PartialRedundancyEliminator::candidates(
+	vector<Statement>& _statements,
+	size_t _begin,
+	size_t _index
+) const
+{
+	vector<VariableDeclaration*> result;
+	for (size_t i = _begin; i < _statements.size(); ++i)
+	{
+		Statement& statement = _statements[i];
+		if (statement.type() != typeid(VariableDeclaration))
+			continue;
+		VariableDeclaration& varDecl = boost::get<VariableDeclaration>(statement);
+		if (varDecl.variables.size() != 1 || !varDecl.value)
+			continue;
+		// There is nothing to gain for literals and identifiers.
+		if (
+			varDecl.value->type() != typeid(FunctionalInstruction) &&
+			varDecl.value->type() != typeid(FunctionCall)
+		)
+			continue;
+		MovableChecker checker{m_dialect, *varDecl.value};
+		if (!checker.movable())
+			continue;
+		bool valueAvailable = true;
+		for (YulString name: checker.referencedVariables())
+			if (
+				m_assignedVariables.count(name) ||
+				(m_declaredAt.count(name) && m_declaredAt.at(name) >= _index)
+			)
+				valueAvailable = false;
+		if (valueAvailable)
+			result.emplace_back(&varDecl);
+	}
+	return result;
+}
+
+vector<Statement> PartialRedundancyEliminator::hoist(vector<Statement>& _statements, size_t _index)
+{
+	vector<Block*> branches;
+	bool allPathsCovered = false;
+	if (_statements[_index].type() == typeid(If))
+		branches.emplace_back(&boost::get<If>(_statements[_index]).body);
+	else if (_statements[_index].type() == typeid(Switch))
+		for (auto& switchCase: boost::get<Switch>(_statements[_index]).cases)
+		{
+			branches.emplace_back(&switchCase.body);
+			if (!switchCase.value)
+				allPathsCovered = true;
+		}
+	else
+		return {};
+
+	struct Occurrences
+	{
+		Expression const* expression = nullptr;
+		set<size_t> branches;
+		bool following = false;
+		vector<VariableDeclaration*> declarations;
+	};
+	vector<Occurrences> occurrences;
+	map<uint64_t, vector<size_t>> occurrencesByHash;
+	auto record = [&](VariableDeclaration* _varDecl, boost::optional<size_t> _branch)
+	{
+		vector<size_t>& sameHash = occurrencesByHash[ExpressionHasher::run(*_varDecl->value)];
+		Occurrences* found = nullptr;
+		for (size_t index: sameHash)
+			if (SyntacticallyEqual{}(*occurrences[index].expression, *_varDecl->value))
+				found = &occurrences[index];
+		if (!found)
+		{
+			sameHash.emplace_back(occurrences.size());
+			occurrences.emplace_back();
+			found = &occurrences.back();
+			found->expression = _varDecl->value.get();
+		}
+		if (_branch)
+			found->branches.insert(*_branch);
+		else
+			found->following = true;
+		found->declarations.emplace_back(_varDecl);
+	};
+
+	for (size_t i = 0; i < branches.size(); ++i)
+		for (VariableDeclaration* varDecl: candidates(branches[i]->statements, 0, _index))
+			record(varDecl, i);
+	for (VariableDeclaration* varDecl: candidates(_statements, _index + 1, _index))
+		record(varDecl, boost::none);
+
+	vector<Statement> hoisted;
+	for (auto& occurrence: occurrences)
+	{
+		if (occurrence.branches.empty())
+			continue;
+		if (!occurrence.following && !(allPathsCovered && occurrence.branches.size() == branches.size()))
+			continue;
+
+		VariableDeclaration& first = *occurrence.declarations.front();
+		YulString name = m_nameDispenser.newName(first.variables.front().name);
+		hoisted.emplace_back(VariableDeclaration{
+			first.location,
+			{TypedName{first.location, name, first.variables.front().type}},
+			make_unique<Expression>(*occurrence.expression)
+		});
+		for (VariableDeclaration* varDecl: occurrence.declarations)
+			*varDecl->value = Identifier{varDecl->location, name};
+	}
+	return hoisted;
+}
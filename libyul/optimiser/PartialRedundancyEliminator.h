@@ -0,0 +1,117 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Optimiser component that moves expressions that are computed on all paths
+ * through an if or switch statement in front of it.
+ */
+#pragma once
+
+#include <libyul/optimiser/ASTWalker.h>
+#include <libyul/YulString.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace yul
+{
+struct Dialect;
+class NameDispenser;
+
+/**
+ * Optimiser component that removes partial redundancies across control flow.
+ *
+ * The CommonSubexpressionEliminator only replaces an expression by a variable
+ * if the variable is declared in a dominating position. Since Yul only has
+ * structured control flow, a statement dominates all statements that follow it
+ * in the same block (including nested ones), so expressions that are computed
+ * in both branches of a switch, or inside an if statement and again after it,
+ * are recomputed.
+ *
+ * This component detects such expressions and computes them once in front
+ * of the if or switch statement. More specifically, an expression is moved
+ * in front of the statement if it is the value of a variable declaration at the top
+ * level of
+ *  - every case of a switch statement with default case or
+ *  - at least one case of a switch statement or the body of an if statement,
+ *    and one of the statements following it in the same block.
+ * The declarations are changed to refer to the new variable.
+ *
+ * The expression has to be movable, it can only reference variables that are
+ * declared before the if or switch statement and are never re-assigned.
+ * Equal expressions are found by hashing them using the ExpressionHasher.
+ *
+ * Example:
+ *
+ *   let x := calldataload(0)
+ *   switch x
+ *   case 0 { let a := add(x, 1) sstore(0, a) }
+ *   default { let b := add(x, 1) sstore(1, b) }
+ *
+ * is transformed into
+ *
+ *   let x := calldataload(0)
+ *   let a_1 := add(x, 1)
+ *   switch x
+ *   case 0 { let a := a_1 sstore(0, a) }
+ *   default { let b := a_1 sstore(1, b) }
+ *
+ * Blocks are processed from the innermost to the outermost, so expressions can
+ * be moved across multiple nested control flow statements.
+ *
+ * Prerequisite: Disambiguator, ForLoopInitRewriter.
+ * Works best if the code is in SSA form and the expressions are split.
+ */
+class PartialRedundancyEliminator: public ASTModifier
+{
+public:
+	static void run(Dialect const& _dialect, Block& _ast, NameDispenser& _nameDispenser);
+
+	using ASTModifier::operator();
+	void operator()(Block& _block) override;
+
+private:
+	PartialRedundancyEliminator(
+		Dialect const& _dialect,
+		NameDispenser& _nameDispenser,
+		std::set<YulString> _assignedVariables
+	):
+		m_dialect(_dialect),
+		m_nameDispenser(_nameDispenser),
+		m_assignedVariables(std::move(_assignedVariables))
+	{}
+
+	/// @returns the variable declarations in @a _statements starting at @a _begin
+	/// whose values are candidates to be moved in front of the statement at @a _index
+	/// of the current block.
+	std::vector<VariableDeclaration*> candidates(
+		std::vector<Statement>& _statements,
+		size_t _begin,
+		size_t _index
+	) const;
+	/// @returns the declarations to be inserted in front of the statement at @a _index.
+	std::vector<Statement> hoist(std::vector<Statement>& _statements, size_t _index);
+
+	Dialect const& m_dialect;
+	NameDispenser& m_nameDispenser;
+	std::set<YulString> m_assignedVariables;
+	/// Index of the statement of the current block that (possibly nested) declares
+	/// the given variable.
+	std::map<YulString, size_t> m_declaredAt;
+};
+
+}
@@ -0,0 +1,448 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Optimiser component that removes storage and memory stores whose values
+ * are never read.
+ */
+
+#include <libyul/optimiser/RedundantStoreEliminator.h>
+
+#include <libyul/optimiser/Semantics.h>
+#include <libyul/optimiser/SSAValueTracker.h>
+#include <libyul/backends/evm/EVMDialect.h>
+#include <libyul/AsmData.h>
+#include <libyul/Utilities.h>
+
+#include <libdevcore/CommonData.h>
+
+#include <boost/range/algorithm_ext/erase.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace yul;
+
+namespace
+{
+
+class StoreRemover: public ASTModifier
+{
+public:
+	explicit StoreRemover(set<ExpressionStatement const*> const& _toRemove):
+		m_toRemove(_toRemove)
+	{}
+	void operator()(Block& _block) override
+	{
+		boost::range::remove_erase_if(_block.statements, [=](Statement const& _statement) -> bool {
+			return
+				_statement.type() == typeid(ExpressionStatement) &&
+				m_toRemove.count(&boost::get<ExpressionStatement>(_statement));
+		});
+
+		ASTModifier::operator()(_block);
+	}
+
+private:
+	set<ExpressionStatement const*> const& m_toRemove;
+};
+
+bool readsStorage(dev::eth::Instruction _instruction)
+{
+	switch (_instruction)
+	{
+	case dev::eth::Instruction::SLOAD:
+	case dev::eth::Instruction::CALL:
+	case dev::eth::Instruction::CALLCODE:
+	case dev::eth::Instruction::DELEGATECALL:
+	case dev::eth::Instruction::STATICCALL:
+	case dev::eth::Instruction::CREATE:
+	case dev::eth::Instruction::CREATE2:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool readsMemory(dev::eth::Instruction _instruction)
+{
+	switch (_instruction)
+	{
+	case dev::eth::Instruction::MLOAD:
+	case dev::eth::Instruction::KECCAK256:
+	case dev::eth::Instruction::LOG0:
+	case dev::eth::Instruction::LOG1:
+	case dev::eth::Instruction::LOG2:
+	case dev::eth::Instruction::LOG3:
+	case dev::eth::Instruction::LOG4:
+	case dev::eth::Instruction::CALL:
+	case dev::eth::Instruction::CALLCODE:
+	case dev::eth::Instruction::DELEGATECALL:
+	case dev::eth::Instruction::STATICCALL:
+	case dev::eth::Instruction::CREATE:
+	case dev::eth::Instruction::CREATE2:
+	case dev::eth::Instruction::MSIZE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+}
+
+void RedundantStoreEliminator::run(Dialect const& _dialect, Block& _ast)
+{
+	EVMDialect const* dialect = dynamic_cast<EVMDialect const*>(&_dialect);
+	if (!dialect)
+		return;
+
+	SSAValueTracker ssaValues;
+	ssaValues(_ast);
+	bool containsMSize = SideEffectsCollector(_dialect, _ast).containsMSize();
+
+	RedundantStoreEliminator rse{*dialect, ssaValues.values(), !containsMSize};
+	rse(_ast);
+	// The code might be a fragment that is embedded in other code,
+	// so everything could still be read at its end.
+	rse.finalize(State::Used);
+
+	StoreRemover remover{rse.m_pendingRemovals};
+	remover(_ast);
+}
+
+void RedundantStoreEliminator::operator()(ExpressionStatement const& _statement)
+{
+	ASTWalker::operator()(_statement);
+
+	if (auto store = trackedStore(_statement))
+	{
+		if (store->key)
+			for (auto& tracked: m_stores)
+			{
+				StoreInfo const& other = m_storeInfo.at(tracked.first);
+				if (
+					tracked.second == State::Undecided &&
+					other.location == store->location &&
+					other.key &&
+					*other.key == *store->key
+				)
+					tracked.second = State::Unused;
+			}
+		m_storeInfo.emplace(&_statement, *store);
+		// Default-construct it in "Undecided" state if it does not yet exist.
+		m_stores[&_statement];
+	}
+}
+
+void RedundantStoreEliminator::operator()(FunctionalInstruction const& _instruction)
+{
+	ASTWalker::operator()(_instruction);
+	handleInstruction(_instruction.instruction, _instruction.arguments);
+}
+
+void RedundantStoreEliminator::operator()(FunctionCall const& _functionCall)
+{
+	ASTWalker::operator()(_functionCall);
+
+	if (BuiltinFunctionForEVM const* builtin = m_dialect.builtin(_functionCall.functionName.name))
+	{
+		if (builtin->instruction)
+			handleInstruction(*builtin->instruction, _functionCall.arguments);
+		else if (!builtin->movable)
+			changeUndecidedTo(State::Used);
+	}
+	else
+		// The function can read anything.
+		changeUndecidedTo(State::Used);
+}
+
+void RedundantStoreEliminator::operator()(VariableDeclaration const& _variableDeclaration)
+{
+	ASTWalker::operator()(_variableDeclaration);
+
+	if (m_forLoopNestingDepth > 0)
+		for (auto const& var: _variableDeclaration.variables)
+			m_loopVariables.emplace(var.name);
+}
+
+void RedundantStoreEliminator::operator()(If const& _if)
+{
+	visit(*_if.condition);
+
+	TrackedStores skipBranch{m_stores};
+	(*this)(_if.body);
+
+	merge(m_stores, move(skipBranch));
+}
+
+void RedundantStoreEliminator::operator()(Switch const& _switch)
+{
+	visit(*_switch.expression);
+
+	TrackedStores const preState{m_stores};
+
+	bool hasDefault = false;
+	vector<TrackedStores> branches;
+	for (auto const& c: _switch.cases)
+	{
+		if (!c.value)
+			hasDefault = true;
+		(*this)(c.body);
+		branches.emplace_back(move(m_stores));
+		m_stores = preState;
+	}
+
+	if (hasDefault)
+	{
+		m_stores = move(branches.back());
+		branches.pop_back();
+	}
+	for (auto& branch: branches)
+		merge(m_stores, move(branch));
+}
+
+void RedundantStoreEliminator::operator()(FunctionDefinition const& _functionDefinition)
+{
+	TrackedStores outerStores;
+	ForLoopInfo forLoopInfo;
+	size_t outerForLoopNestingDepth = 0;
+	swap(m_stores, outerStores);
+	swap(m_forLoopInfo, forLoopInfo);
+	swap(m_forLoopNestingDepth, outerForLoopNestingDepth);
+
+	(*this)(_functionDefinition.body);
+
+	// The caller can read all stores.
+	finalize(State::Used);
+
+	swap(m_stores, outerStores);
+	swap(m_forLoopInfo, forLoopInfo);
+	swap(m_forLoopNestingDepth, outerForLoopNestingDepth);
+}
+
+void RedundantStoreEliminator::operator()(ForLoop const& _forLoop)
+{
+	ForLoopInfo outerForLoopInfo;
+	swap(outerForLoopInfo, m_forLoopInfo);
+	++m_forLoopNestingDepth;
+
+	// If the pre block was not empty,
+	// we would have to deal with more complicated scoping rules.
+	assertThrow(_forLoop.pre.statements.empty(), OptimizerException, "");
+
+	// We just run the loop twice to account for the back edge.
+	// There need not be more runs because we only have three different states.
+
+	visit(*_forLoop.condition);
+
+	TrackedStores zeroRuns{m_stores};
+
+	(*this)(_forLoop.body);
+	merge(m_stores, move(m_forLoopInfo.pendingContinueStmts));
+	m_forLoopInfo.pendingContinueStmts = {};
+	(*this)(_forLoop.post);
+
+	visit(*_forLoop.condition);
+
+	if (m_forLoopNestingDepth < 6)
+	{
+		// Do the second run only for small nesting depths to avoid horrible runtime.
+		TrackedStores oneRun{m_stores};
+
+		(*this)(_forLoop.body);
+
+		merge(m_stores, move(m_forLoopInfo.pendingContinueStmts));
+		m_forLoopInfo.pendingContinueStmts.clear();
+		(*this)(_forLoop.post);
+
+		visit(*_forLoop.condition);
+		// Order of merging does not matter because "max" is commutative and associative.
+		merge(m_stores, move(oneRun));
+	}
+	else
+		// Shortcut to avoid horrible runtime:
+		// Change all stores that were newly introduced in the for loop to "used".
+		for (auto& store: m_stores)
+			if (!zeroRuns.count(store.first))
+				store.second = State::Used;
+
+	// Order of merging does not matter because "max" is commutative and associative.
+	merge(m_stores, move(zeroRuns));
+	merge(m_stores, move(m_forLoopInfo.pendingBreakStmts));
+	m_forLoopInfo.pendingBreakStmts.clear();
+
+	// Restore potential outer for-loop states.
+	swap(m_forLoopInfo, outerForLoopInfo);
+	--m_forLoopNestingDepth;
+}
+
+void RedundantStoreEliminator::operator()(Break const&)
+{
+	m_forLoopInfo.pendingBreakStmts.emplace_back(move(m_stores));
+	m_stores.clear();
+}
+
+void RedundantStoreEliminator::operator()(Continue const&)
+{
+	m_forLoopInfo.pendingContinueStmts.emplace_back(move(m_stores));
+	m_stores.clear();
+}
+
+boost::optional<RedundantStoreEliminator::StoreInfo> RedundantStoreEliminator::trackedStore(
+	ExpressionStatement const& _statement
+) const
+{
+	if (_statement.expression.type() != typeid(FunctionCall))
+		return boost::none;
+	FunctionCall const& funCall = boost::get<FunctionCall>(_statement.expression);
+	BuiltinFunctionForEVM const* builtin = m_dialect.builtin(funCall.functionName.name);
+	if (!builtin || !builtin->instruction)
+		return boost::none;
+
+	Location location;
+	if (*builtin->instruction == dev::eth::Instruction::SSTORE)
+		location = Location::Storage;
+	else if (*builtin->instruction == dev::eth::Instruction::MSTORE && m_trackMemory)
+		location = Location::Memory;
+	else
+		return boost::none;
+
+	for (Expression const& argument: funCall.arguments)
+		if (!SideEffectsCollector{m_dialect, argument}.movable())
+			return boost::none;
+	return StoreInfo{location, keyOf(funCall.arguments.at(0))};
+}
+
+boost::optional<RedundantStoreEliminator::Key> RedundantStoreEliminator::keyOf(Expression const& _expression) const
+{
+	if (auto value = constantValue(_expression))
+		return Key{*value};
+	if (_expression.type() == typeid(Identifier))
+	{
+		YulString name = boost::get<Identifier>(_expression).name;
+		if (m_ssaValues.count(name) && !m_loopVariables.count(name))
+			return Key{name};
+	}
+	return boost::none;
+}
+
+boost::optional<u256> RedundantStoreEliminator::constantValue(Expression const& _expression) const
+{
+	Expression const* expression = &_expression;
+	if (expression->type() == typeid(Identifier))
+	{
+		auto it = m_ssaValues.find(boost::get<Identifier>(*expression).name);
+		expression = it == m_ssaValues.end() ? nullptr : it->second;
+	}
+	if (expression && expression->type() == typeid(Literal))
+		return valueOfLiteral(boost::get<Literal>(*expression));
+	return boost::none;
+}
+
+void RedundantStoreEliminator::handleInstruction(dev::eth::Instruction _instruction, vector<Expression> const& _arguments)
+{
+	switch (_instruction)
+	{
+	case dev::eth::Instruction::STOP:
+	case dev::eth::Instruction::SELFDESTRUCT:
+		changeUndecidedTo(Location::Storage, State::Used);
+		changeUndecidedTo(Location::Memory, State::Unused);
+		break;
+	case dev::eth::Instruction::RETURN:
+		changeUndecidedTo(Location::Storage, State::Used);
+		readMemoryArea(_arguments.at(0), _arguments.at(1), State::Unused);
+		break;
+	case dev::eth::Instruction::REVERT:
+		changeUndecidedTo(Location::Storage, State::Unused);
+		readMemoryArea(_arguments.at(0), _arguments.at(1), State::Unused);
+		break;
+	case dev::eth::Instruction::INVALID:
+		changeUndecidedTo(State::Unused);
+		break;
+	default:
+		if (readsStorage(_instruction))
+			changeUndecidedTo(Location::Storage, State::Used);
+		if (readsMemory(_instruction))
+			changeUndecidedTo(Location::Memory, State::Used);
+		break;
+	}
+}
+
+void RedundantStoreEliminator::readMemoryArea(Expression const& _offset, Expression const& _size, State _otherState)
+{
+	boost::optional<u256> offset = constantValue(_offset);
+	boost::optional<u256> size = constantValue(_size);
+	for (auto& tracked: m_stores)
+	{
+		StoreInfo const& store = m_storeInfo.at(tracked.first);
+		if (store.location != Location::Memory || tracked.second != State::Undecided)
+			continue;
+		boost::optional<u256> storeOffset;
+		if (store.key && store.key->type() == typeid(u256))
+			storeOffset = boost::get<u256>(*store.key);
+		bool disjoint =
+			size && (
+				*size == 0 ||
+				(offset && storeOffset && (
+					bigint(*storeOffset) + 32 <= bigint(*offset) ||
+					bigint(*offset) + bigint(*size) <= bigint(*storeOffset)
+				))
+			);
+		tracked.second = disjoint ? _otherState : State::Used;
+	}
+}
+
+void RedundantStoreEliminator::merge(TrackedStores& _target, TrackedStores&& _source)
+{
+	for (auto& store: _source)
+	{
+		auto it = _target.find(store.first);
+		if (it == _target.end())
+			_target.emplace(store.first, store.second);
+		else
+			State::join(it->second, store.second);
+	}
+	_source.clear();
+}
+
+void RedundantStoreEliminator::merge(TrackedStores& _target, vector<TrackedStores>&& _source)
+{
+	for (TrackedStores& ts: _source)
+		merge(_target, move(ts));
+	_source.clear();
+}
+
+void RedundantStoreEliminator::changeUndecidedTo(Location _location, State _newState)
+{
+	for (auto& store: m_stores)
+		if (store.second == State::Undecided && m_storeInfo.at(store.first).location == _location)
+			store.second = _newState;
+}
+
+void RedundantStoreEliminator::changeUndecidedTo(State _newState)
+{
+	for (auto& store: m_stores)
+		if (store.second == State::Undecided)
+			store.second = _newState;
+}
+
+void RedundantStoreEliminator::finalize(State _newState)
+{
+	changeUndecidedTo(_newState);
+	for (auto const& store: m_stores)
+		if (store.second == State::Unused)
+			m_pendingRemovals.insert(store.first);
+	m_stores.clear();
+}
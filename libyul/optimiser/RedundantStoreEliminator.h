@@ -0,0 +1,200 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Optimiser component that removes storage and memory stores whose values
+ * are never read.
+ */
+
+#pragma once
+
+#include <libyul/AsmDataForward.h>
+#include <libyul/optimiser/ASTWalker.h>
+
+#include <libevmasm/Instruction.h>
+
+#include <libdevcore/Common.h>
+
+#include <boost/optional.hpp>
+#include <boost/variant.hpp>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace yul
+{
+struct Dialect;
+struct EVMDialect;
+
+/**
+ * Optimiser component that removes ``sstore`` and ``mstore`` statements whose
+ * stored value cannot be observed. This component respects the control-flow
+ * and takes it into account for removal, using the same approach as the
+ * RedundantAssignEliminator.
+ *
+ * Example:
+ *
+ * {
+ *   let x := calldataload(0)
+ *   sstore(0, x)
+ *   if x { sstore(0, 2) revert(0, 0) }
+ *   mstore(0, x)
+ *   sstore(0, 3)
+ *   return(0x20, 0x20)
+ * }
+ *
+ * Both "sstore(0, x)" and "sstore(0, 2)" are removed: on the path through
+ * the if statement, the transaction is reverted and on the other path the
+ * slot is overwritten by "sstore(0, 3)". "mstore(0, x)" is removed because
+ * the returned memory area does not overlap with the stored word.
+ *
+ * Detailed rules:
+ *
+ * Only stores whose arguments are movable are considered. The AST is traversed
+ * twice: in an information gathering step and in the actual removal step.
+ * During information gathering, we maintain a mapping from store statements
+ * to the three states "unused", "undecided" and "used", exactly like the
+ * RedundantAssignEliminator does for assignments. Control flow splits and
+ * joins as well as for loops, break and continue are handled in the same way.
+ *
+ * When a store is visited, it is added to the mapping in the "undecided" state
+ * and every other store to the same location that is still in the "undecided"
+ * state is changed to "unused". Two locations are the same if the keys are
+ * the same constant or the same variable that is never re-assigned and
+ * not declared inside a for loop.
+ *
+ * Any operation that can read storage (``sload``, calls, ``create``, calls to
+ * user-defined functions) changes all "undecided" storage stores to "used"
+ * and the same happens for memory stores at operations that can read memory.
+ * ``return`` and ``revert`` only read the given memory area, which is taken
+ * into account if all offsets are constant.
+ *
+ * At ``stop``, ``return`` and ``selfdestruct``, all remaining "undecided" storage
+ * stores are changed to "used" and at ``revert`` and ``invalid`` to "unused".
+ * Memory stores that are still "undecided" at that point are changed to "unused".
+ * At the end of a function and at the end of the code, all "undecided" stores are
+ * changed to "used", because the code might be embedded into other code (this is
+ * the case for the assembly snippets of the code generator).
+ *
+ * In the second traversal, all stores that are in the "unused" state are removed.
+ *
+ * Memory stores are not removed if the code contains ``msize``.
+ * The component only works for EVM dialects.
+ *
+ * Works best if the code is in SSA form.
+ *
+ * Prerequisite: Disambiguator, ForLoopInitRewriter.
+ */
+class RedundantStoreEliminator: public ASTWalker
+{
+public:
+	static void run(Dialect const& _dialect, Block& _ast);
+
+	using ASTWalker::operator();
+	void operator()(ExpressionStatement const& _statement) override;
+	void operator()(FunctionalInstruction const& _instruction) override;
+	void operator()(FunctionCall const& _functionCall) override;
+	void operator()(VariableDeclaration const& _variableDeclaration) override;
+	void operator()(If const& _if) override;
+	void operator()(Switch const& _switch) override;
+	void operator()(FunctionDefinition const&) override;
+	void operator()(ForLoop const&) override;
+	void operator()(Break const&) override;
+	void operator()(Continue const&) override;
+
+private:
+	RedundantStoreEliminator(
+		EVMDialect const& _dialect,
+		std::map<YulString, Expression const*> _ssaValues,
+		bool _trackMemory
+	):
+		m_dialect(_dialect),
+		m_ssaValues(std::move(_ssaValues)),
+		m_trackMemory(_trackMemory)
+	{}
+
+	class State
+	{
+	public:
+		enum Value { Unused, Undecided, Used };
+		State(Value _value = Undecided): m_value(_value) {}
+		inline bool operator==(State _other) const { return m_value == _other.m_value; }
+		inline bool operator!=(State _other) const { return !operator==(_other); }
+		static inline void join(State& _a, State const& _b)
+		{
+			// Using "max" works here because of the order of the values in the enum.
+			_a.m_value =  Value(std::max(int(_a.m_value), int(_b.m_value)));
+		}
+	private:
+		Value m_value = Undecided;
+	};
+
+	enum class Location { Storage, Memory };
+	/// A constant or a variable that is never re-assigned.
+	using Key = boost::variant<YulString, dev::u256>;
+	struct StoreInfo
+	{
+		Location location;
+		boost::optional<Key> key;
+	};
+
+	using TrackedStores = std::map<ExpressionStatement const*, State>;
+
+	/// @returns the location of the store if @a _statement is an sstore or mstore
+	/// with movable arguments that should be tracked.
+	boost::optional<StoreInfo> trackedStore(ExpressionStatement const& _statement) const;
+	boost::optional<Key> keyOf(Expression const& _expression) const;
+	boost::optional<dev::u256> constantValue(Expression const& _expression) const;
+
+	/// Updates the states of the tracked stores for a call to the given instruction.
+	void handleInstruction(dev::eth::Instruction _instruction, std::vector<Expression> const& _arguments);
+	/// Changes all undecided memory stores that might overlap with the memory area
+	/// given by the offset and size to "used" and all others to @a _otherState.
+	void readMemoryArea(Expression const& _offset, Expression const& _size, State _otherState);
+
+	/// Joins the store mapping of @a _source into @a _target.
+	/// Will destroy @a _source.
+	static void merge(TrackedStores& _target, TrackedStores&& _source);
+	static void merge(TrackedStores& _target, std::vector<TrackedStores>&& _source);
+	void changeUndecidedTo(Location _location, State _newState);
+	void changeUndecidedTo(State _newState);
+	/// Changes all undecided stores to @a _newState and moves the stores
+	/// that are unused to the pending removals.
+	void finalize(State _newState);
+
+	EVMDialect const& m_dialect;
+	std::map<YulString, Expression const*> m_ssaValues;
+	bool m_trackMemory = false;
+	/// Variables declared inside for loops, their value can change between iterations.
+	std::set<YulString> m_loopVariables;
+	std::map<ExpressionStatement const*, StoreInfo> m_storeInfo;
+	std::set<ExpressionStatement const*> m_pendingRemovals;
+	TrackedStores m_stores;
+
+	/// Working data for traversing for-loops.
+	struct ForLoopInfo
+	{
+		/// Tracked store states for each break statement.
+		std::vector<TrackedStores> pendingBreakStmts;
+		/// Tracked store states for each continue statement.
+		std::vector<TrackedStores> pendingContinueStmts;
+	};
+	ForLoopInfo m_forLoopInfo;
+	size_t m_forLoopNestingDepth = 0;
+};
+
+}
@@ -27,12 +27,16 @@
 #include <libyul/optimiser/DeadCodeEliminator.h>
 #include <libyul/optimiser/FunctionGrouper.h>
 #include <libyul/optimiser/FunctionHoister.h>
+#include <libyul/optimiser/FunctionSpecializer.h>
 #include <libyul/optimiser/EquivalentFunctionCombiner.h>
 #include <libyul/optimiser/ExpressionSplitter.h>
 #include <libyul/optimiser/ExpressionJoiner.h>
 #include <libyul/optimiser/ExpressionInliner.h>
 #include <libyul/optimiser/FullInliner.h>
 #include <libyul/optimiser/ForLoopInitRewriter.h>
+#include <libyul/optimiser/LoadResolver.h>
+#include <libyul/optimiser/LoopInvariantCodeMotion.h>
+#include <libyul/optimiser/PartialRedundancyEliminator.h>
 #include <libyul/optimiser/Rematerialiser.h>
 #include <libyul/optimiser/UnusedPruner.h>
 #include <libyul/optimiser/ExpressionSimplifier.h>
@@ -42,9 +46,11 @@
 #include <libyul/optimiser/StackCompressor.h>
 #include <libyul/optimiser/StructuralSimplifier.h>
 #include <libyul/optimiser/RedundantAssignEliminator.h>
+#include <libyul/optimiser/RedundantStoreEliminator.h>
 #include <libyul/optimiser/VarNameCleaner.h>
 #include <libyul/optimiser/Metrics.h>
 #include <libyul/backends/evm/ConstantOptimiser.h>
+#include <libyul/backends/evm/EVMMetrics.h>
 #include <libyul/AsmAnalysis.h>
 #include <libyul/AsmAnalysisInfo.h>
 #include <libyul/AsmData.h>
@@ -110,6 +116,10 @@ void OptimiserSuite::run(
 
 			ExpressionSimplifier::run(_dialect, ast);
 			CommonSubexpressionEliminator{_dialect}(ast);
+			PartialRedundancyEliminator::run(_dialect, ast, dispenser);
+			LoadResolver::run(_dialect, ast);
+			RedundantStoreEliminator::run(_dialect, ast);
+			LoopInvariantCodeMotion::run(_dialect, ast);
 		}
 
 		{
@@ -158,7 +168,9 @@ void OptimiserSuite::run(
 			// run full inliner
 			FunctionGrouper{}(ast);
 			EquivalentFunctionCombiner::run(ast);
-			FullInliner{ast, dispenser}.run();
+			if (_meter)
+				FunctionSpecializer::run(_dialect, ast, dispenser, _meter->expectedExecutionsPerDeployment());
+			FullInliner{ast, dispenser, _meter}.run();
 			BlockFlattener{}(ast);
 		}
 
@@ -173,6 +185,7 @@ void OptimiserSuite::run(
 			DeadCodeEliminator{_dialect}(ast);
 			ControlFlowSimplifier{_dialect}(ast);
 			CommonSubexpressionEliminator{_dialect}(ast);
+			LoadResolver::run(_dialect, ast);
 			SSATransform::run(ast, dispenser);
 			RedundantAssignEliminator::run(_dialect, ast);
 			RedundantAssignEliminator::run(_dialect, ast);
@@ -139,6 +139,14 @@ static string const g_strOptimizeYul = "optimize-yul";
 static string const g_strOutputDir = "output-dir";
 static string const g_strOverwrite = "overwrite";
 static string const g_strSignatureHashes = "hashes";
+static string const g_strSMTCacheDir = "smt-cache-dir";
+static string const g_strSMTContractTimeout = "smt-contract-timeout";
+static string const g_strSMTInlineFunctions = "smt-inline-functions";
+static string const g_strSMTMemoryLimit = "smt-memory-limit";
+static string const g_strSMTReport = "smt-report";
+static string const g_strSMTSolver = "smt-solver";
+static string const g_strSMTTargetTimeout = "smt-target-timeout";
+static string const g_strSMTWorkers = "smt-workers";
 static string const g_strSources = "sources";
 static string const g_strSourceList = "sourceList";
 static string const g_strSrcMap = "srcmap";
@@ -184,6 +192,14 @@ static string const g_argOptimize = g_strOptimize;
 static string const g_argOptimizeRuns = g_strOptimizeRuns;
 static string const g_argOutputDir = g_strOutputDir;
 static string const g_argSignatureHashes = g_strSignatureHashes;
+static string const g_argSMTCacheDir = g_strSMTCacheDir;
+static string const g_argSMTContractTimeout = g_strSMTContractTimeout;
+static string const g_argSMTInlineFunctions = g_strSMTInlineFunctions;
+static string const g_argSMTMemoryLimit = g_strSMTMemoryLimit;
+static string const g_argSMTReport = g_strSMTReport;
+static string const g_argSMTSolver = g_strSMTSolver;
+static string const g_argSMTTargetTimeout = g_strSMTTargetTimeout;
+static string const g_argSMTWorkers = g_strSMTWorkers;
 static string const g_argStandardJSON = g_strStandardJSON;
 static string const g_argStrictAssembly = g_strStrictAssembly;
 static string const g_argVersion = g_strVersion;
@@ -263,6 +279,40 @@ static bool needsHumanTargetedStdout(po::variables_map const& _args)
 	return false;
 }
 
+void CommandLineInterface::handleSMTReport()
+{
+	if (!m_args.count(g_argSMTReport))
+		return;
+
+	ostringstream report;
+	report << "Location\tContract\tTarget\tResult\tSolver\tTime (ms)\tEliminated nodes" << endl;
+	for (VerificationTargetReport const& target: m_compiler->modelCheckerReport())
+	{
+		if (target.location.source)
+			report << target.location.source->name();
+		if (target.location.source && target.location.start >= 0)
+		{
+			int line;
+			int column;
+			tie(line, column) = target.location.source->translatePositionToLineColumn(target.location.start);
+			report << ":" << (line + 1) << ":" << (column + 1);
+		}
+		report <<
+			"\t" << target.contract <<
+			"\t" << target.kind <<
+			"\t" << target.result <<
+			"\t" << (target.solver.empty() ? "-" : target.solver) <<
+			"\t" << target.time.count() <<
+			"\t" << target.eliminatedNodes <<
+			endl;
+	}
+
+	if (m_args.count(g_argOutputDir))
+		createFile("smt_report.txt", report.str());
+	else
+		sout() << endl << "SMTChecker report:" << endl << report.str();
+}
+
 void CommandLineInterface::handleBinary(string const& _contract)
 {
 	if (m_args.count(g_argBinary))
@@ -708,6 +758,44 @@ Allowed options)",
 		(g_argNoColor.c_str(), "Explicitly disable colored output, disabling terminal auto-detection.")
 		(g_argNewReporter.c_str(), "Enables new diagnostics reporter.")
 		(g_argErrorRecovery.c_str(), "Enables additional parser error recovery.")
+		(
+			g_argSMTWorkers.c_str(),
+			po::value<unsigned>()->value_name("n")->default_value(1),
+			"Number of threads the SMTChecker uses to check the verification targets of a function concurrently. "
+			"The warnings, including their counterexamples, do not depend on the number of threads."
+		)
+		(
+			g_argSMTCacheDir.c_str(),
+			po::value<string>()->value_name("path"),
+			"Directory in which the SMTChecker stores the results of its queries to reuse them in later compilations."
+		)
+		(
+			g_argSMTSolver.c_str(),
+			po::value<string>()->value_name("command"),
+			"Command of an SMT-LIB2 solver that the SMTChecker starts to answer its queries "
+			"via standard input and output, e.g. \"z3 -in\" or \"cvc4 --lang smt2 --incremental\"."
+		)
+		(
+			g_argSMTTargetTimeout.c_str(),
+			po::value<unsigned>()->value_name("ms")->default_value(ModelCheckerSettings{}.targetTimeout),
+			"Time in milliseconds the SMTChecker spends at most on a single verification target (0 for no limit)."
+		)
+		(
+			g_argSMTContractTimeout.c_str(),
+			po::value<unsigned>()->value_name("ms")->default_value(ModelCheckerSettings{}.contractTimeout),
+			"Time in milliseconds the SMTChecker spends at most on the verification targets of a contract (0 for no limit). "
+			"Targets that are not checked within this time are listed as not checked."
+		)
+		(
+			g_argSMTMemoryLimit.c_str(),
+			po::value<unsigned>()->value_name("MB")->default_value(ModelCheckerSettings{}.memoryLimit),
+			"Memory in megabytes a solver of the SMTChecker may use for a single query (0 for no limit). Only supported by Z3."
+		)
+		(
+			g_argSMTInlineFunctions.c_str(),
+			"Inline all internal function calls in the SMTChecker instead of using summaries of pure and view functions. "
+			"Slower, but checks the verification targets of the called functions for every call."
+		)
 		(g_argIgnoreMissingFiles.c_str(), "Ignore missing files.");
 	po::options_description outputComponents("Output Components");
 	outputComponents.add_options()
@@ -725,7 +813,8 @@ Allowed options)",
 		(g_argSignatureHashes.c_str(), "Function signature hashes of the contracts.")
 		(g_argNatspecUser.c_str(), "Natspec user documentation of all contracts.")
 		(g_argNatspecDev.c_str(), "Natspec developer documentation of all contracts.")
-		(g_argMetadata.c_str(), "Combined Metadata JSON whose Swarm hash is stored on-chain.");
+		(g_argMetadata.c_str(), "Combined Metadata JSON whose Swarm hash is stored on-chain.")
+		(g_argSMTReport.c_str(), "Result, solver and time of each verification target of the SMTChecker.");
 	desc.add(outputComponents);
 
 	po::options_description allOptions = desc;
@@ -946,6 +1035,21 @@ bool CommandLineInterface::processInput()
 		if (m_args.count(g_argErrorRecovery))
 			m_compiler->setParserErrorRecovery(true);
 		m_compiler->setEVMVersion(m_evmVersion);
+		ModelCheckerSettings modelCheckerSettings;
+		modelCheckerSettings.workers = max(1u, m_args[g_argSMTWorkers].as<unsigned>());
+		if (m_args.count(g_argSMTCacheDir))
+			modelCheckerSettings.cacheDirectory = m_args[g_argSMTCacheDir].as<string>();
+		if (m_args.count(g_argSMTSolver))
+		{
+			string command = boost::trim_copy(m_args[g_argSMTSolver].as<string>());
+			if (!command.empty())
+				boost::split(modelCheckerSettings.solverCommand, command, boost::is_space(), boost::token_compress_on);
+		}
+		modelCheckerSettings.targetTimeout = m_args[g_argSMTTargetTimeout].as<unsigned>();
+		modelCheckerSettings.contractTimeout = m_args[g_argSMTContractTimeout].as<unsigned>();
+		modelCheckerSettings.memoryLimit = m_args[g_argSMTMemoryLimit].as<unsigned>();
+		modelCheckerSettings.inlineFunctionCalls = m_args.count(g_argSMTInlineFunctions);
+		m_compiler->setModelCheckerSettings(modelCheckerSettings);
 		// TODO: Perhaps we should not compile unless requested
 
 		m_compiler->enableIRGeneration(m_args.count(g_argIR));
@@ -1435,6 +1539,8 @@ void CommandLineInterface::outputCompilationResults()
 		handleNatspec(false, contract);
 	} // end of contracts iteration
 
+	handleSMTReport();
+
 	if (!g_hasOutput)
 	{
 		if (m_args.count(g_argOutputDir))
@@ -70,6 +70,31 @@ BOOST_AUTO_TEST_CASE(strings)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(batch)
+{
+	BOOST_CHECK(keccak256Batch({}).empty());
+
+	// Inputs around the block size of 136 bytes, in groups of varying size.
+	vector<bytes> inputs;
+	for (size_t length = 0; length < 300; length += 7)
+		for (size_t copy = 0; copy < length % 6; copy++)
+			inputs.push_back(bytes(length, uint8_t(length + copy)));
+	vector<bytesConstRef> refs;
+	for (bytes const& input: inputs)
+		refs.push_back(bytesConstRef(&input));
+
+	vector<h256> hashes = keccak256Batch(refs);
+	BOOST_REQUIRE_EQUAL(hashes.size(), inputs.size());
+	for (size_t i = 0; i < inputs.size(); i++)
+		BOOST_CHECK_EQUAL(hashes[i], keccak256(inputs[i]));
+
+	string const test = "test";
+	BOOST_CHECK_EQUAL(
+		keccak256Batch({bytesConstRef(test), bytesConstRef(test), bytesConstRef(test), bytesConstRef(test)})[3],
+		FixedHash<32>("0x9c22ff5f21f0b81b113e63f7db6da94fedef11b2119b4088b89664fb9a3cb658")
+	);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
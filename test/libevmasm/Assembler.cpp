@@ -148,6 +148,59 @@ BOOST_AUTO_TEST_CASE(all_assembly_items)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(shared_sub_assemblies)
+{
+	// Both sub-assemblies of the main assembly embed the same assembly.
+	shared_ptr<Assembly> shared = make_shared<Assembly>();
+	shared->append(Instruction::CALLVALUE);
+	shared->append(Instruction::STOP);
+
+	shared_ptr<Assembly> subA = make_shared<Assembly>();
+	auto sub = subA->appendSubroutine(shared);
+	subA->pushSubroutineOffset(size_t(sub.data()));
+	subA->append(Instruction::STOP);
+
+	shared_ptr<Assembly> subB = make_shared<Assembly>();
+	subB->append(Instruction::ADDRESS);
+	sub = subB->appendSubroutine(shared);
+	subB->pushSubroutineOffset(size_t(sub.data()));
+	subB->append(Instruction::STOP);
+
+	Assembly _assembly;
+	sub = _assembly.appendSubroutine(subA);
+	_assembly.pushSubroutineOffset(size_t(sub.data()));
+	sub = _assembly.appendSubroutine(subB);
+	_assembly.pushSubroutineOffset(size_t(sub.data()));
+	_assembly.append(Instruction::STOP);
+
+	checkCompilation(_assembly);
+
+	BOOST_CHECK_EQUAL(
+		_assembly.assemble().toHex(),
+		"6008600a6009601200fe"
+		"6002600600fe3400"
+		"306002600700fe3400"
+	);
+	BOOST_CHECK_EQUAL(shared->assemble().toHex(), "3400");
+}
+
+BOOST_AUTO_TEST_CASE(source_mapping)
+{
+	auto source = make_shared<CharStream>("", "a.sol");
+	AssemblyItems items{
+		AssemblyItem(Instruction::CALLVALUE, {1, 3, source}),
+		AssemblyItem(Instruction::CALLVALUE, {1, 3, source}),
+		AssemblyItem(Instruction::JUMP, {1, 3, source}),
+		AssemblyItem(Instruction::STOP)
+	};
+	items[2].setJumpType(AssemblyItem::JumpType::IntoFunction);
+	BOOST_CHECK_EQUAL(
+		computeSourceMapping(items, {{"a.sol", 0}}),
+		"1:2:0:-;;:::i;-1:-1:-1:-"
+	);
+	BOOST_CHECK_EQUAL(computeSourceMapping(items, {}), "1:2::-;;:::i;-1:-1::-");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -25,8 +25,10 @@
 #include <libevmasm/CommonSubexpressionEliminator.h>
 #include <libevmasm/PeepholeOptimiser.h>
 #include <libevmasm/JumpdestRemover.h>
+#include <libevmasm/JumpThreader.h>
 #include <libevmasm/ControlFlowGraph.h>
 #include <libevmasm/BlockDeduplicator.h>
+#include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/Assembly.h>
 
 #include <boost/test/unit_test.hpp>
@@ -1158,6 +1160,188 @@ BOOST_AUTO_TEST_CASE(jumpdest_removal_subassemblies)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(jump_threading)
+{
+	AssemblyItems items{
+		Instruction::CALLVALUE,
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMPI,
+		Instruction::STOP,
+		AssemblyItem(Tag, 1),
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 2),
+		Instruction::CALLVALUE,
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMP
+	};
+	AssemblyItems expectation{
+		Instruction::CALLVALUE,
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMPI,
+		Instruction::STOP,
+		AssemblyItem(Tag, 1),
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 2),
+		Instruction::CALLVALUE,
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMP
+	};
+	JumpThreader threader(items);
+	BOOST_REQUIRE(threader.optimise({}));
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(jump_threading_cycle)
+{
+	AssemblyItems items{
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 1),
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 2),
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMP
+	};
+	// The jumps are not threaded, but the block of tag 2 is moved.
+	AssemblyItems expectation{
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 1),
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMP
+	};
+	JumpThreader threader(items);
+	BOOST_CHECK(threader.optimise({}));
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(block_reordering)
+{
+	AssemblyItems items{
+		Instruction::CALLVALUE,
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMPI,
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 1),
+		u256(1),
+		Instruction::STOP,
+		AssemblyItem(Tag, 2),
+		u256(2),
+		Instruction::STOP
+	};
+	AssemblyItems expectation{
+		Instruction::CALLVALUE,
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMPI,
+		u256(2),
+		Instruction::STOP,
+		AssemblyItem(Tag, 1),
+		u256(1),
+		Instruction::STOP
+	};
+	AssemblyItems original = items;
+	// Tags referenced from outside have to stay.
+	JumpThreader(items).optimise({2});
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		original.begin(), original.end()
+	);
+
+	JumpThreader threader(items);
+	BOOST_REQUIRE(threader.optimise({}));
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(block_reordering_nested)
+{
+	// The block of tag 2 is moved into the block of tag 1, which is moved itself.
+	AssemblyItems items{
+		Instruction::CALLVALUE,
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 2),
+		u256(2),
+		Instruction::STOP,
+		AssemblyItem(Tag, 1),
+		u256(1),
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMP
+	};
+	AssemblyItems expectation{
+		Instruction::CALLVALUE,
+		u256(1),
+		u256(2),
+		Instruction::STOP
+	};
+	JumpThreader threader(items);
+	BOOST_REQUIRE(threader.optimise({}));
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(block_reordering_cycle)
+{
+	// Each block jumps to the other one, so only one of them can be moved.
+	AssemblyItems items{
+		Instruction::STOP,
+		AssemblyItem(Tag, 1),
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 2),
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMP
+	};
+	AssemblyItems expectation{
+		Instruction::STOP,
+		AssemblyItem(Tag, 2),
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMP
+	};
+	JumpThreader threader(items);
+	BOOST_REQUIRE(threader.optimise({}));
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(block_reordering_stored_tag)
+{
+	// Tag 2 is also stored as a value, so its block cannot be moved.
+	AssemblyItems items{
+		AssemblyItem(PushTag, 2),
+		u256(0),
+		Instruction::SSTORE,
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 2),
+		u256(2),
+		Instruction::STOP
+	};
+	AssemblyItems expectation = items;
+	JumpThreader threader(items);
+	BOOST_CHECK(!threader.optimise({}));
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+}
+
 BOOST_AUTO_TEST_CASE(cse_sub_zero)
 {
 	checkCSE({
@@ -1370,6 +1554,69 @@ BOOST_AUTO_TEST_CASE(cse_replace_too_large_shift)
 	});
 }
 
+BOOST_AUTO_TEST_CASE(constant_optimiser_shifted_mask)
+{
+	EVMVersion evmVersion = EVMVersion::constantinople();
+	u256 mask = (u256(1) << 160) - 1;
+	AssemblyItems expectation{
+		u256(0),
+		Instruction::NOT,
+		u256(96),
+		Instruction::SHR,
+		Instruction::POP
+	};
+	// The second run is answered from the representation cache and has to yield the same result.
+	for (unsigned i = 0; i < 2; ++i)
+	{
+		Assembly assembly;
+		assembly.append(mask);
+		assembly.append(Instruction::POP);
+		BOOST_CHECK_EQUAL(ConstantOptimisationMethod::optimiseConstants(false, 200, evmVersion, assembly), 1);
+		AssemblyItems const& output = assembly.items();
+		BOOST_CHECK_EQUAL_COLLECTIONS(expectation.begin(), expectation.end(), output.begin(), output.end());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(constant_optimiser_power)
+{
+	u256 value = boost::multiprecision::pow(u256(10), 60);
+	AssemblyItems expectation{
+		u256(60),
+		u256(10),
+		Instruction::EXP,
+		Instruction::POP
+	};
+	Assembly assembly;
+	assembly.append(value);
+	assembly.append(Instruction::POP);
+	BOOST_CHECK_EQUAL(ConstantOptimisationMethod::optimiseConstants(false, 1, EVMVersion::homestead(), assembly), 1);
+	AssemblyItems const& output = assembly.items();
+	BOOST_CHECK_EQUAL_COLLECTIONS(expectation.begin(), expectation.end(), output.begin(), output.end());
+}
+
+BOOST_AUTO_TEST_CASE(constant_optimiser_difference_to_power_of_two)
+{
+	// 2**200 - 10**20, where the difference is not small enough for the decomposition.
+	u256 difference = boost::multiprecision::pow(u256(10), 20);
+	u256 value = (u256(1) << 200) - difference;
+	AssemblyItems expectation{
+		u256(20),
+		u256(10),
+		Instruction::EXP,
+		u256(1),
+		u256(200),
+		Instruction::SHL,
+		Instruction::SUB,
+		Instruction::POP
+	};
+	Assembly assembly;
+	assembly.append(value);
+	assembly.append(Instruction::POP);
+	BOOST_CHECK_EQUAL(ConstantOptimisationMethod::optimiseConstants(false, 1, EVMVersion::constantinople(), assembly), 1);
+	AssemblyItems const& output = assembly.items();
+	BOOST_CHECK_EQUAL_COLLECTIONS(expectation.begin(), expectation.end(), output.begin(), output.end());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -20,9 +20,25 @@
 
 #include <test/libsolidity/AnalysisFramework.h>
 
+#include <test/Options.h>
+
+#include <libsolidity/formal/ConstraintSlicer.h>
+#include <libsolidity/formal/ExpressionSimplifier.h>
+#include <libsolidity/formal/SMTLib2Interface.h>
+#include <libsolidity/formal/SMTPortfolio.h>
+#include <libsolidity/formal/SolverProcess.h>
+
+#include <libdevcore/Keccak256.h>
+
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <set>
 #include <string>
+#include <unordered_set>
 
 using namespace std;
 using namespace langutil;
@@ -54,6 +70,57 @@ protected:
 			_allowRecoveryErrors
 		);
 	}
+
+	/// Warnings and report of the SMTChecker for a source unit.
+	struct SMTCheckerResult
+	{
+		/// Messages, including the secondary messages such as counterexamples, and start
+		/// offsets of the warnings, -1 if they do not have a location.
+		std::vector<std::pair<std::string, int>> warnings;
+		ModelCheckerReport report;
+
+		/// @returns the number of warnings whose message contains @a _message.
+		size_t count(std::string const& _message) const
+		{
+			size_t result = 0;
+			for (auto const& warning: warnings)
+				if (warning.first.find(_message) != std::string::npos)
+					result++;
+			return result;
+		}
+		/// @returns the start offsets of the warnings whose message contains @a _message.
+		std::set<int> locations(std::string const& _message) const
+		{
+			std::set<int> result;
+			for (auto const& warning: warnings)
+				if (warning.first.find(_message) != std::string::npos)
+					result.insert(warning.second);
+			return result;
+		}
+	};
+
+	/// Compiles @a _source, which has to enable the SMTChecker itself, up to the analysis
+	/// using @a _settings.
+	SMTCheckerResult analyse(std::string const& _source, ModelCheckerSettings const& _settings)
+	{
+		CompilerStack compiler;
+		compiler.setSources({{"", "pragma solidity >=0.0;\n" + _source}});
+		compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+		compiler.setModelCheckerSettings(_settings);
+		BOOST_REQUIRE(compiler.parseAndAnalyze());
+		SMTCheckerResult result;
+		for (auto const& error: compiler.errors())
+		{
+			auto location = boost::get_error_info<errinfo_sourceLocation>(*error);
+			std::string message = *error->comment();
+			if (auto secondary = boost::get_error_info<errinfo_secondarySourceLocation>(*error))
+				for (auto const& info: secondary->infos)
+					message += "\n" + info.first;
+			result.warnings.emplace_back(message, location ? location->start : -1);
+		}
+		result.report = compiler.modelCheckerReport();
+		return result;
+	}
 };
 
 BOOST_FIXTURE_TEST_SUITE(SMTChecker, SMTCheckerFramework)
@@ -248,6 +315,371 @@ BOOST_AUTO_TEST_CASE(mod)
 	CHECK_SUCCESS_NO_WARNINGS(text);
 }
 
+BOOST_AUTO_TEST_CASE(concurrent_verification_targets)
+{
+	string text = R"(
+		pragma experimental SMTChecker;
+		contract C {
+			uint s;
+			function f(uint x, uint y, int a) public returns (uint) {
+				uint z = x + y;
+				assert(z >= x);
+				int b = a - 1;
+				s = b > 0 ? z * 2 : s - 1;
+				require(y < 10);
+				return x / y + s;
+			}
+		}
+	)";
+	ModelCheckerSettings settings;
+	auto sequential = analyse(text, settings).warnings;
+	BOOST_CHECK(sequential.size() > 2);
+	// The counterexamples do not depend on the number of workers either.
+	BOOST_CHECK(analyse(text, settings).count("  x = ") > 0);
+	for (unsigned workers: {2u, 4u, 4u})
+	{
+		settings.workers = workers;
+		BOOST_CHECK(sequential == analyse(text, settings).warnings);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(query_cache)
+{
+	string text = R"(
+		pragma experimental SMTChecker;
+		contract C {
+			function f(uint x, uint y) public pure returns (uint) {
+				assert(x > 0);
+				return x / y;
+			}
+		}
+	)";
+	boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+	ScopeGuard removeDirectory([&]() { boost::filesystem::remove_all(directory); });
+	ModelCheckerSettings settings;
+	settings.cacheDirectory = directory.string();
+	auto warnings = [&]() { return analyse(text, settings).warnings; };
+	auto uncached = warnings();
+	BOOST_CHECK(uncached == warnings());
+	// The results are only cached if there is an integrated solver.
+	if (boost::filesystem::is_empty(directory))
+		return;
+	// Replaces the cached results to check that they are used.
+	for (auto const& entry: boost::filesystem::directory_iterator(directory))
+	{
+		ofstream file(entry.path().string());
+		file << R"({"result":"unsat","values":[]})";
+	}
+	BOOST_CHECK(warnings().size() < uncached.size());
+}
+
+BOOST_AUTO_TEST_CASE(verification_target_report)
+{
+	string text = R"(
+		pragma experimental SMTChecker;
+		contract C {
+			function f(uint x, uint y) public pure returns (uint) {
+				assert(x > 0);
+				if (y == 2) return 1;
+				return x / y;
+			}
+		}
+	)";
+	auto result = analyse(text, ModelCheckerSettings{});
+	ModelCheckerReport const& report = result.report;
+	BOOST_CHECK_EQUAL(result.count("time budget"), 0);
+	set<string> kinds;
+	for (auto const& target: report)
+	{
+		BOOST_CHECK_EQUAL(target.contract, "C");
+		BOOST_CHECK(target.location.start >= 0);
+		BOOST_CHECK(target.result != "not checked");
+		kinds.insert(target.kind);
+	}
+	BOOST_CHECK(kinds == (set<string>{"constant condition", "assert", "division by zero", "underflow", "overflow"}));
+
+	// Every target is still listed if the time budget is exhausted before the first one.
+	ModelCheckerSettings settings;
+	settings.deadline = chrono::steady_clock::now();
+	result = analyse(text, settings);
+	BOOST_CHECK_EQUAL(result.report.size(), report.size());
+	for (auto const& target: result.report)
+		BOOST_CHECK_EQUAL(target.result, "not checked");
+	BOOST_CHECK_EQUAL(result.count("time budget"), 1);
+	BOOST_CHECK_EQUAL(result.count(to_string(report.size()) + " verification target(s) were not checked"), 1);
+}
+
+BOOST_AUTO_TEST_CASE(function_summaries)
+{
+	map<h256, string> responses;
+	smt::SMTLib2Interface solver(responses);
+	auto intSort = make_shared<smt::Sort>(smt::Kind::Int);
+	smt::Expression a = solver.newVariable("a", intSort);
+	smt::Expression b = solver.newVariable("b", intSort);
+	smt::Expression c = solver.newVariable("c", intSort);
+	smt::Expression formula = a == b + 1 && a > 2;
+	BOOST_CHECK(formula.substitute({{"a", c * 2}}).identical(c * 2 == b + 1 && c * 2 > 2));
+	BOOST_CHECK(formula.substitute({{"c", b}}).identical(formula));
+
+	string text = R"(
+		pragma experimental SMTChecker;
+		library SafeMath {
+			function add(uint a, uint b) internal pure returns (uint) {
+				uint c = a + b;
+				require(c >= a);
+				return c;
+			}
+			function sub(uint a, uint b) internal pure returns (uint) {
+				require(b <= a);
+				return a - b;
+			}
+		}
+		contract C {
+			using SafeMath for uint;
+			uint s;
+			function total() internal view returns (uint) { return s; }
+			function f(uint x, uint y) public {
+				uint z = x.add(y).add(1);
+				assert(z > x);
+				assert(z.sub(1).sub(y) == x);
+				s = z;
+				assert(total() == z);
+				assert(total() == y);
+			}
+		}
+		contract D {
+			function g(uint[] memory a) internal pure { a[0] = 5; }
+			function f(uint[] memory b) public pure {
+				b[0] = 1;
+				g(b);
+				assert(b[0] == 1);
+			}
+		}
+	)";
+	ModelCheckerSettings settings;
+	settings.inlineFunctionCalls = true;
+	auto inlined = analyse(text, settings);
+	settings.inlineFunctionCalls = false;
+	auto summarized = analyse(text, settings);
+	auto violations = inlined.locations("Assertion violation");
+	if (violations.empty())
+		// There is no solver.
+		return;
+	// The summaries are as precise as inlining for these functions, but the
+	// targets of the called functions are only checked once. Functions that
+	// change their array arguments are inlined.
+	BOOST_CHECK_EQUAL(violations.size(), 2);
+	BOOST_CHECK(summarized.locations("Assertion violation") == violations);
+	BOOST_CHECK(summarized.report.size() < inlined.report.size());
+}
+
+BOOST_AUTO_TEST_CASE(expression_hash_consing)
+{
+	map<h256, string> responses;
+	smt::SMTLib2Interface solver(responses);
+	auto intSort = make_shared<smt::Sort>(smt::Kind::Int);
+	smt::Expression x = solver.newVariable("x", intSort);
+	smt::Expression y = solver.newVariable("y", intSort);
+
+	// Structurally equal expressions share their node, however they were constructed.
+	smt::Expression a = smt::Expression::ite(x > y, x + y * 2, x - 1);
+	smt::Expression b = smt::Expression::ite(solver.newVariable("x", intSort) > y, x + y * 2, x - size_t(1));
+	BOOST_CHECK(a.identical(b));
+	BOOST_CHECK_EQUAL(a.hash(), b.hash());
+	BOOST_CHECK(!a.identical(smt::Expression::ite(x > y, x + y * 2, x - 2)));
+	BOOST_CHECK(!(x + y).identical(y + x));
+
+	// Every branch refers to the value of the previous one twice, so the tree of the
+	// encoding doubles with every branch, but its number of distinct nodes only grows linearly.
+	size_t const branches = 40;
+	smt::Expression value = x;
+	for (size_t i = 0; i < branches; ++i)
+		value = smt::Expression::ite(value > i, value + 1, value * 2);
+	unordered_set<smt::Expression, smt::ExpressionHash, smt::ExpressionIdentical> nodes;
+	vector<smt::Expression> stack{value};
+	while (!stack.empty())
+	{
+		smt::Expression expression = stack.back();
+		stack.pop_back();
+		if (nodes.insert(expression).second)
+			for (auto const& argument: expression.arguments())
+				stack.push_back(argument);
+	}
+	// x and one literal, comparison, addition, multiplication and ite per branch,
+	// since the literals 1 and 2 are shared with the comparisons.
+	BOOST_CHECK_EQUAL(nodes.size(), 1 + 5 * branches);
+}
+
+BOOST_AUTO_TEST_CASE(constraint_slicer)
+{
+	map<h256, string> responses;
+	smt::SMTLib2Interface solver(responses);
+	auto intSort = make_shared<smt::Sort>(smt::Kind::Int);
+	smt::Expression a = solver.newVariable("a", intSort);
+	smt::Expression b = solver.newVariable("b", intSort);
+	smt::Expression c = solver.newVariable("c", intSort);
+	smt::Expression d = solver.newVariable("d", intSort);
+	smt::Expression e = solver.newVariable("e", intSort);
+
+	smt::ConstraintSlicer slicer;
+	// The definitions of d and e are not needed for the target a > 2.
+	smt::Expression formula = a == b + 1 && d == c * 2 && b == c && e == d && a > 2;
+	BOOST_CHECK(slicer.slice(formula).identical(a == b + 1 && b == c && a > 2));
+	// Constraints that are not definitions are always kept.
+	formula = a == b + 1 && d > c && a > 2;
+	BOOST_CHECK(slicer.slice(formula).identical(formula));
+	// Only the first equality of a variable counts as its definition.
+	formula = d == 1 && d == 2 && a > 2;
+	BOOST_CHECK(slicer.slice(formula).identical(formula));
+	// Cyclic definitions cannot be removed.
+	formula = d == e + 1 && e == d && a > 2;
+	BOOST_CHECK(slicer.slice(formula).identical(formula));
+	// Variables of the assertions of the solver keep their definitions.
+	slicer.addRoots(e > 0);
+	formula = a == b + 1 && d == c * 2 && b == c && e == d && a > 2;
+	BOOST_CHECK(slicer.slice(formula).identical(formula));
+}
+
+BOOST_AUTO_TEST_CASE(expression_simplifier)
+{
+	map<h256, string> responses;
+	smt::SMTLib2Interface solver(responses);
+	auto intSort = make_shared<smt::Sort>(smt::Kind::Int);
+	smt::Expression a = solver.newVariable("a", intSort);
+	smt::Expression b = solver.newVariable("b", intSort);
+	smt::Expression c = solver.newVariable("c", make_shared<smt::Sort>(smt::Kind::Bool));
+	smt::Expression t(true);
+	smt::Expression f(false);
+
+	smt::ExpressionSimplifier simplifier;
+	BOOST_CHECK(simplifier.simplify(smt::Expression(size_t(2)) + 3 * smt::Expression(size_t(4))).identical(smt::Expression(size_t(14))));
+	BOOST_CHECK(simplifier.simplify(smt::Expression(bigint(-7)) / 2).identical(smt::Expression(bigint(-7)) / 2));
+	BOOST_CHECK(simplifier.simplify(a * 1 + (b - b)).identical(a));
+	BOOST_CHECK(simplifier.simplify(smt::Expression::ite(t, a, b) == a).identical(t));
+	BOOST_CHECK(simplifier.simplify(smt::Expression::ite(c, a + 0, a)).identical(a));
+	BOOST_CHECK(simplifier.simplify(smt::Expression::ite(c, t, f) || f).identical(c));
+	BOOST_CHECK(simplifier.simplify(!!(a < b)).identical(a < b));
+	BOOST_CHECK(simplifier.simplify(smt::Expression::implies(c, f)).identical(!c));
+	BOOST_CHECK(simplifier.simplify(c && (a > 1 && smt::Expression(size_t(1)) < 2)).identical(c && a > 1));
+	// Duplicate conjuncts, e.g. range constraints, are removed at any depth.
+	smt::Expression range = a >= 0 && a <= 255;
+	smt::Expression formula = ((range && c) && (b > a && range)) && (a >= 0);
+	smt::Expression simplified = ((a >= 0 && a <= 255) && c) && b > a;
+	BOOST_CHECK(simplifier.simplify(formula).identical(simplified));
+	BOOST_CHECK(simplifier.simplify(formula && (a == a + 0 || f) && t).identical(simplified));
+	// There is no normalization of terms.
+	BOOST_CHECK(simplifier.simplify(formula && (a + 1 < 1 + a || f)).identical(simplified && a + 1 < 1 + a));
+	BOOST_CHECK(simplifier.simplify(formula && !(a - a <= 0)).identical(f));
+	// Formulas that cannot be simplified are returned as they are.
+	formula = (a > b && c) && !c;
+	BOOST_CHECK(simplifier.simplify(formula).identical(formula));
+
+	size_t eliminated = simplifier.eliminatedNodes();
+	BOOST_CHECK(eliminated > 0);
+	simplifier.simplify(smt::Expression(size_t(1)) + 1);
+	BOOST_CHECK_EQUAL(simplifier.eliminatedNodes(), eliminated + 1);
+}
+
+BOOST_AUTO_TEST_CASE(check_assuming)
+{
+	map<h256, string> responses;
+	auto intSort = make_shared<smt::Sort>(smt::Kind::Int);
+
+	// The SMT-LIB2 query is the same as if the assumptions were asserted in a scope of their own.
+	smt::SMTLib2Interface smtlib2(responses);
+	smt::Expression y = smtlib2.newVariable("y", intSort);
+	smtlib2.addAssertion(y > 0);
+	string query = smtlib2.checkQuery({y < 2, y != 0}, {y});
+	smtlib2.push();
+	smtlib2.addAssertion(y < 2);
+	smtlib2.addAssertion(y != 0);
+	BOOST_CHECK_EQUAL(query, smtlib2.checkQuery({}, {y}));
+	smtlib2.pop();
+	// Prepared queries are answered like the query they were built from.
+	responses[keccak256(query)] = "sat\n((y 1))\n";
+	auto prepared = smtlib2.checkPreparedQuery(query, {y < 2, y != 0}, {y});
+	BOOST_CHECK(prepared.first == smt::CheckResult::SATISFIABLE);
+	BOOST_CHECK(prepared.second == vector<string>{"1"});
+	BOOST_CHECK(smtlib2.checkAssuming({y < 2, y != 0}, {y}) == prepared);
+
+	smt::SMTPortfolio solver(responses);
+	if (!solver.hasSolver())
+		return;
+	smt::Expression x = solver.newVariable("x", intSort);
+	solver.addAssertion(x > 0);
+	BOOST_CHECK(solver.checkAssuming({x < 0}, {}).first == smt::CheckResult::UNSATISFIABLE);
+	auto result = solver.checkAssuming({x < 2}, {x});
+	BOOST_REQUIRE(result.first == smt::CheckResult::SATISFIABLE);
+	BOOST_CHECK_EQUAL(result.second.front(), "1");
+	// The assumptions only hold for their query.
+	BOOST_CHECK(solver.checkAssuming({x > 5}, {}).first == smt::CheckResult::SATISFIABLE);
+	BOOST_CHECK(solver.check({}).first == smt::CheckResult::SATISFIABLE);
+	// Assumptions can be reused after the scope they were first used in was popped.
+	solver.push();
+	solver.addAssertion(x < 3);
+	BOOST_CHECK(solver.checkAssuming({x > 5}, {}).first == smt::CheckResult::UNSATISFIABLE);
+	solver.pop();
+	BOOST_CHECK(solver.checkAssuming({x > 5}, {}).first == smt::CheckResult::SATISFIABLE);
+	BOOST_CHECK(solver.checkAssuming({x < 0}, {}).first == smt::CheckResult::UNSATISFIABLE);
+}
+
+#ifndef _WIN32
+BOOST_AUTO_TEST_CASE(solver_process)
+{
+	// `cat` echoes the commands, which is enough to check how responses are split.
+	smt::SolverProcess process({"cat"});
+	atomic<bool> interrupted{false};
+	auto deadline = []() { return chrono::steady_clock::now() + chrono::seconds(10); };
+	BOOST_REQUIRE(process.write("sat\n((|x (1)| 1)\n (y (- 2)))\nunknown\n", deadline(), interrupted));
+	BOOST_CHECK_EQUAL(*process.read(deadline(), interrupted), "sat");
+	BOOST_CHECK_EQUAL(*process.read(deadline(), interrupted), "((|x (1)| 1)\n (y (- 2)))");
+	BOOST_CHECK_EQUAL(*process.read(deadline(), interrupted), "unknown");
+	// Incomplete responses are not returned.
+	BOOST_REQUIRE(process.write("(error \"a)\"", deadline(), interrupted));
+	BOOST_CHECK(!process.read(chrono::steady_clock::now() + chrono::milliseconds(100), interrupted));
+	BOOST_REQUIRE(process.write(")\n", deadline(), interrupted));
+	BOOST_CHECK_EQUAL(*process.read(deadline(), interrupted), "(error \"a)\")");
+	// Inputs that do not fit into the buffers do not block, even if the process
+	// writes its output at the same time.
+	BOOST_REQUIRE(process.write(string(size_t(1) << 23, ' ') + "unsat\n", deadline(), interrupted));
+	BOOST_CHECK_EQUAL(*process.read(deadline(), interrupted), "unsat");
+	interrupted = true;
+	BOOST_CHECK(!process.read(deadline(), interrupted));
+	BOOST_CHECK(!process.write(string(size_t(1) << 23, ' '), deadline(), interrupted));
+
+	BOOST_CHECK_THROW(smt::SolverProcess({"solc-test-nonexistent-solver"}), smt::SolverError);
+}
+
+BOOST_AUTO_TEST_CASE(solver_process_identity)
+{
+	map<h256, string> responses;
+	// `cat` answers `(get-info :version)` with the command itself.
+	BOOST_CHECK_EQUAL(smt::SMTLib2Interface(responses, {"cat"}).identity(), "smtlib2 cat (get-info :version)");
+	// Results of solvers that do not report their version are not cached.
+	BOOST_CHECK_EQUAL(smt::SMTLib2Interface(responses, {"solc-test-nonexistent-solver"}).identity(), "");
+	BOOST_CHECK_EQUAL(smt::SMTLib2Interface(responses).identity(), "");
+}
+
+BOOST_AUTO_TEST_CASE(portfolio_waits_for_slow_solvers)
+{
+	// A solver that takes a while to disagree with the integrated solvers.
+	vector<string> slowSolver{
+		"sh", "-c",
+		"while read -r line; do case \"$line\" in "
+		"*get-info*) echo '(:version \"slow\")';; "
+		"*check-sat*) sleep 2; echo unsat;; "
+		"esac; done"
+	};
+	map<h256, string> responses;
+	smt::SMTPortfolio solver(responses, nullptr, slowSolver);
+	if (solver.solvers() < 2)
+		return;
+	smt::Expression x = solver.newVariable("x", make_shared<smt::Sort>(smt::Kind::Int));
+	solver.addAssertion(x > 0);
+	BOOST_CHECK(solver.check({}).first == smt::CheckResult::CONFLICTING);
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -714,6 +714,48 @@ BOOST_AUTO_TEST_CASE(library_filename_with_colon)
 	BOOST_CHECK(contract["evm"]["bytecode"]["linkReferences"]["git:library.sol"]["L"][0].isObject());
 }
 
+BOOST_AUTO_TEST_CASE(model_checker_invalid_workers)
+{
+	char const* input = R"(
+	{
+		"language": "Solidity",
+		"settings": {
+			"modelChecker": {
+				"workers": "4"
+			}
+		},
+		"sources": {
+			"empty": {
+				"content": ""
+			}
+		}
+	}
+	)";
+	Json::Value result = compile(input);
+	BOOST_CHECK(containsError(result, "JSONError", "\"settings.modelChecker.workers\" must be an unsigned number"));
+}
+
+BOOST_AUTO_TEST_CASE(model_checker_unknown_key)
+{
+	char const* input = R"(
+	{
+		"language": "Solidity",
+		"settings": {
+			"modelChecker": {
+				"timeout": 10
+			}
+		},
+		"sources": {
+			"empty": {
+				"content": ""
+			}
+		}
+	}
+	)";
+	Json::Value result = compile(input);
+	BOOST_CHECK(containsError(result, "JSONError", "Unknown key \"timeout\""));
+}
+
 BOOST_AUTO_TEST_CASE(libraries_invalid_top_level)
 {
 	char const* input = R"(
@@ -17,13 +17,13 @@ contract C {
 // optimize-yul: true
 // ----
 // creation:
-//   codeDepositCost: 610600
-//   executionCost: 645
-//   totalCost: 611245
+//   codeDepositCost: 588600
+//   executionCost: 619
+//   totalCost: 589219
 // external:
-//   a(): 429
-//   b(uint256): 884
-//   f1(uint256): 351
+//   a(): 397
+//   b(uint256): 852
+//   f1(uint256): 319
 //   f2(uint256[],string[],uint16,address): infinite
 //   f3(uint16[],string[],uint16,address): infinite
 //   f4(uint32[],string[12],bytes[2][],address): infinite
@@ -72,7 +72,8 @@ BOOST_AUTO_TEST_CASE(single_var_assigned_plus_code)
 BOOST_AUTO_TEST_CASE(single_var_assigned_plus_code_and_reused)
 {
 	string out = assemble("{ let x := 1 mstore(3, 4) pop(mload(x)) }");
-	BOOST_CHECK_EQUAL(out, "PUSH1 0x1 PUSH1 0x4 PUSH1 0x3 MSTORE DUP1 MLOAD POP POP ");
+	// The last reference to x consumes its stack slot.
+	BOOST_CHECK_EQUAL(out, "PUSH1 0x1 PUSH1 0x4 PUSH1 0x3 MSTORE MLOAD POP ");
 }
 
 BOOST_AUTO_TEST_CASE(multi_reuse_single_slot)
@@ -337,8 +338,8 @@ BOOST_AUTO_TEST_CASE(reuse_slots_function_with_gaps)
 		// stack: d c x3 a b
 		"POP "
 		// stack: d c x3 a
-		"DUP1 DUP3 MSTORE "
-		"POP POP "
+		"DUP2 MSTORE " // a is consumed
+		"POP "
 		// stack: d c
 		"DUP2 DUP2 MSTORE "
 		"POP POP "
@@ -346,6 +347,32 @@ BOOST_AUTO_TEST_CASE(reuse_slots_function_with_gaps)
 }
 
 
+BOOST_AUTO_TEST_CASE(consume_last_reference)
+{
+	string out = assemble("{ let x := mload(0) let y := mload(1) sstore(x, y) }");
+	// The slot of y is used for the argument, x is removed after the statement.
+	BOOST_CHECK_EQUAL(out, "PUSH1 0x0 MLOAD PUSH1 0x1 MLOAD DUP2 SSTORE POP ");
+}
+
+BOOST_AUTO_TEST_CASE(consume_not_in_nested_scope)
+{
+	string out = assemble("{ let x := mload(0) if 1 { sstore(0, x) } }");
+	// References in nested scopes might be inside loops, so x is duplicated.
+	BOOST_CHECK_EQUAL(out, "PUSH1 0x0 MLOAD PUSH1 0x1 ISZERO PUSH1 0xD JUMPI DUP1 PUSH1 0x0 SSTORE JUMPDEST POP ");
+}
+
+BOOST_AUTO_TEST_CASE(consume_not_in_for_loop_condition)
+{
+	string out = assemble("{ for { let i := mload(0) } i {} {} }");
+	BOOST_CHECK_EQUAL(out, "PUSH1 0x0 MLOAD JUMPDEST DUP1 ISZERO PUSH1 0xD JUMPI JUMPDEST PUSH1 0x3 JUMP JUMPDEST POP ");
+}
+
+BOOST_AUTO_TEST_CASE(consume_not_function_parameter)
+{
+	string out = assemble("{ function f(a) { sstore(0, a) } }");
+	BOOST_CHECK_EQUAL(out, "PUSH1 0xA JUMP JUMPDEST DUP1 PUSH1 0x0 SSTORE POP JUMP JUMPDEST ");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
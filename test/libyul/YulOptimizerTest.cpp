@@ -31,11 +31,14 @@
 #include <libyul/optimiser/ExpressionSplitter.h>
 #include <libyul/optimiser/FunctionGrouper.h>
 #include <libyul/optimiser/FunctionHoister.h>
+#include <libyul/optimiser/FunctionSpecializer.h>
 #include <libyul/optimiser/ExpressionInliner.h>
 #include <libyul/optimiser/FullInliner.h>
 #include <libyul/optimiser/ForLoopConditionIntoBody.h>
 #include <libyul/optimiser/ForLoopInitRewriter.h>
 #include <libyul/optimiser/LoadResolver.h>
+#include <libyul/optimiser/LoopInvariantCodeMotion.h>
+#include <libyul/optimiser/PartialRedundancyEliminator.h>
 #include <libyul/optimiser/MainFunction.h>
 #include <libyul/optimiser/NameDisplacer.h>
 #include <libyul/optimiser/Rematerialiser.h>
@@ -45,6 +48,7 @@
 #include <libyul/optimiser/SSAReverser.h>
 #include <libyul/optimiser/SSATransform.h>
 #include <libyul/optimiser/RedundantAssignEliminator.h>
+#include <libyul/optimiser/RedundantStoreEliminator.h>
 #include <libyul/optimiser/StructuralSimplifier.h>
 #include <libyul/optimiser/StackCompressor.h>
 #include <libyul/optimiser/Suite.h>
@@ -193,6 +197,14 @@ TestCase::TestResult YulOptimizerTest::run(ostream& _stream, string const& _line
 		FullInliner(*m_ast, nameDispenser).run();
 		ExpressionJoiner::run(*m_ast);
 	}
+	else if (m_optimizerStep == "functionSpecializer")
+	{
+		disambiguate();
+		(FunctionHoister{})(*m_ast);
+		(FunctionGrouper{})(*m_ast);
+		NameDispenser nameDispenser{*m_dialect, *m_ast};
+		FunctionSpecializer::run(*m_dialect, *m_ast, nameDispenser, 200);
+	}
 	else if (m_optimizerStep == "mainFunction")
 	{
 		disambiguate();
@@ -246,6 +258,19 @@ TestCase::TestResult YulOptimizerTest::run(ostream& _stream, string const& _line
 		disambiguate();
 		RedundantAssignEliminator::run(*m_dialect, *m_ast);
 	}
+	else if (m_optimizerStep == "partialRedundancyEliminator")
+	{
+		disambiguate();
+		ForLoopInitRewriter{}(*m_ast);
+		NameDispenser nameDispenser{*m_dialect, *m_ast};
+		PartialRedundancyEliminator::run(*m_dialect, *m_ast, nameDispenser);
+	}
+	else if (m_optimizerStep == "redundantStoreEliminator")
+	{
+		disambiguate();
+		ForLoopInitRewriter{}(*m_ast);
+		RedundantStoreEliminator::run(*m_dialect, *m_ast);
+	}
 	else if (m_optimizerStep == "ssaPlusCleanup")
 	{
 		disambiguate();
@@ -268,6 +293,12 @@ TestCase::TestResult YulOptimizerTest::run(ostream& _stream, string const& _line
 		ExpressionJoiner::run(*m_ast);
 		ExpressionJoiner::run(*m_ast);
 	}
+	else if (m_optimizerStep == "loopInvariantCodeMotion")
+	{
+		disambiguate();
+		ForLoopInitRewriter{}(*m_ast);
+		LoopInvariantCodeMotion::run(*m_dialect, *m_ast);
+	}
 	else if (m_optimizerStep == "controlFlowSimplifier")
 	{
 		disambiguate();
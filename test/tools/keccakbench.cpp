@@ -0,0 +1,103 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Micro-benchmark comparing single and batch keccak256 hashing.
+ */
+
+#include <libdevcore/Keccak256.h>
+
+#include <boost/program_options.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace dev;
+
+namespace po = boost::program_options;
+
+int main(int argc, char** argv)
+{
+	size_t count = 0;
+	size_t length = 0;
+	size_t repetitions = 0;
+
+	po::options_description options(
+		R"(keccakbench, benchmark for keccak256 hashing.
+Usage: keccakbench [Options]
+Hashes the same set of inputs one by one and in a batch and reports the times.
+
+Allowed options)",
+		po::options_description::m_default_line_length,
+		po::options_description::m_default_line_length - 23);
+	options.add_options()
+		("help", "Show this help screen.")
+		("count", po::value<size_t>(&count)->default_value(4096), "Number of inputs.")
+		("length", po::value<size_t>(&length)->default_value(32), "Length of each input in bytes.")
+		("repetitions", po::value<size_t>(&repetitions)->default_value(100), "Number of repetitions.");
+	po::variables_map arguments;
+	try
+	{
+		po::store(po::command_line_parser(argc, argv).options(options).run(), arguments);
+		po::notify(arguments);
+	}
+	catch (po::error const& _exception)
+	{
+		cerr << _exception.what() << endl;
+		return 1;
+	}
+	if (arguments.count("help"))
+	{
+		cout << options;
+		return 0;
+	}
+
+	vector<bytes> inputs;
+	for (size_t i = 0; i < count; ++i)
+	{
+		bytes input(length);
+		for (size_t j = 0; j < length; ++j)
+			input[j] = uint8_t(i * 31 + j);
+		inputs.emplace_back(move(input));
+	}
+	vector<bytesConstRef> refs;
+	for (bytes const& input: inputs)
+		refs.push_back(bytesConstRef(&input));
+
+	// Accumulate the hashes so that the computation cannot be optimised away.
+	unsigned checksum = 0;
+	auto start = chrono::steady_clock::now();
+	for (size_t r = 0; r < repetitions; ++r)
+		for (bytesConstRef input: refs)
+			checksum += keccak256(input)[0];
+	auto single = chrono::steady_clock::now() - start;
+
+	start = chrono::steady_clock::now();
+	for (size_t r = 0; r < repetitions; ++r)
+		for (h256 const& hash: keccak256Batch(refs))
+			checksum += hash[0];
+	auto batch = chrono::steady_clock::now() - start;
+
+	using milliseconds = chrono::duration<double, milli>;
+	cout << "Hashed " << count << " inputs of " << length << " bytes " << repetitions << " times." << endl;
+	cout << "single: " << milliseconds(single).count() << " ms" << endl;
+	cout << "batch:  " << milliseconds(batch).count() << " ms" << endl;
+	cout << "checksum: " << checksum << endl;
+	return 0;
+}
@@ -38,10 +38,13 @@
 #include <libyul/optimiser/ExpressionSplitter.h>
 #include <libyul/optimiser/FunctionGrouper.h>
 #include <libyul/optimiser/FunctionHoister.h>
+#include <libyul/optimiser/FunctionSpecializer.h>
 #include <libyul/optimiser/ExpressionInliner.h>
 #include <libyul/optimiser/FullInliner.h>
 #include <libyul/optimiser/ForLoopConditionIntoBody.h>
 #include <libyul/optimiser/ForLoopInitRewriter.h>
+#include <libyul/optimiser/LoopInvariantCodeMotion.h>
+#include <libyul/optimiser/PartialRedundancyEliminator.h>
 #include <libyul/optimiser/MainFunction.h>
 #include <libyul/optimiser/Rematerialiser.h>
 #include <libyul/optimiser/ExpressionSimplifier.h>
@@ -49,6 +52,7 @@
 #include <libyul/optimiser/DeadCodeEliminator.h>
 #include <libyul/optimiser/ExpressionJoiner.h>
 #include <libyul/optimiser/RedundantAssignEliminator.h>
+#include <libyul/optimiser/RedundantStoreEliminator.h>
 #include <libyul/optimiser/SSAReverser.h>
 #include <libyul/optimiser/SSATransform.h>
 #include <libyul/optimiser/StackCompressor.h>
@@ -129,10 +133,10 @@ public:
 				disambiguated = true;
 			}
 			cout << "(q)quit/(f)flatten/(c)se/initialize var(d)ecls/(x)plit/(j)oin/(g)rouper/(h)oister/" << endl;
-			cout << "  (e)xpr inline/(i)nline/(s)implify/varname c(l)eaner/(u)nusedprune/ss(a) transform/" << endl;
-			cout << "  (r)edundant assign elim./re(m)aterializer/f(o)r-loop-init-rewriter/f(O)r-loop-condition-into-body/" << endl;
+			cout << "  (e)xpr inline/(i)nline/function (S)pecializer/(s)implify/varname c(l)eaner/(u)nusedprune/ss(a) transform/" << endl;
+			cout << "  (r)edundant assign elim./redundant store (E)lim./re(m)aterializer/f(o)r-loop-init-rewriter/f(O)r-loop-condition-into-body/" << endl;
 			cout << "  s(t)ructural simplifier/equi(v)alent function combiner/ssa re(V)erser/? " << endl;
-			cout << "  co(n)trol flow simplifier/stack com(p)ressor/(D)ead code eliminator/? " << endl;
+			cout << "  co(n)trol flow simplifier/stack com(p)ressor/(D)ead code eliminator/(L)oop-invariant code motion/(P)artial redundancy eliminator/? " << endl;
 			cout.flush();
 			int option = readStandardInputChar();
 			cout << ' ' << char(option) << endl;
@@ -176,6 +180,9 @@ public:
 			case 'i':
 				FullInliner(*m_ast, *m_nameDispenser).run();
 				break;
+			case 'S':
+				FunctionSpecializer::run(m_dialect, *m_ast, *m_nameDispenser, 200);
+				break;
 			case 's':
 				ExpressionSimplifier::run(m_dialect, *m_ast);
 				break;
@@ -197,6 +204,9 @@ public:
 			case 'r':
 				RedundantAssignEliminator::run(m_dialect, *m_ast);
 				break;
+			case 'E':
+				RedundantStoreEliminator::run(m_dialect, *m_ast);
+				break;
 			case 'm':
 				Rematerialiser::run(m_dialect, *m_ast);
 				break;
@@ -206,6 +216,12 @@ public:
 			case 'V':
 				SSAReverser::run(*m_ast);
 				break;
+			case 'L':
+				LoopInvariantCodeMotion::run(m_dialect, *m_ast);
+				break;
+			case 'P':
+				PartialRedundancyEliminator::run(m_dialect, *m_ast, *m_nameDispenser);
+				break;
 			case 'p':
 				StackCompressor::run(m_dialect, *m_ast, true, 16);
 				break;